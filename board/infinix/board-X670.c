@@ -5,9 +5,41 @@
 
 #include <board_ops.h>
 
+enum {
+    SIG_USBDL_ENABLED_1,
+    SIG_USBDL_ENABLED_2,
+    SIG_SEC_BOOT_ENABLED_1,
+    SIG_SEC_BOOT_ENABLED_2,
+    SIG_UNLOCKED_STATUS_1,
+    SIG_UNLOCKED_STATUS_2,
+    SIG_AVB_CMDLINE,
+    SIG_SECCFG_GET_LOCK_STATE,
+    SIG_GET_SBOOT_STATE,
+    SIG_CMDLINE_PRE_PROCESS,
+    SIG_LOAD_AND_VERIFY_VBMETA,
+    SIG_COUNT
+};
+
 static void spoof_lock_state(void) {
     uint32_t addr = 0;
 
+    // Resolve every signature below in a single pass over LK rather
+    // than rescanning the whole image for each one.
+    search_pattern_t sigs[SIG_COUNT] = {
+        [SIG_USBDL_ENABLED_1] = SEARCH_ENTRY(0xF03F, 0xFEE3, 0xB318, 0x68FB), // 3F F0 E3 FE 18 B3 FB 68 @ 4c429d1e
+        [SIG_USBDL_ENABLED_2] = SEARCH_ENTRY(0xF03F, 0xFECC, 0xB190, 0x68FB), // 3f f0 cc fe 90 b1 fb 68 @ 4c429d4c
+        [SIG_SEC_BOOT_ENABLED_1] = SEARCH_ENTRY(0xF040, 0xF97B, 0x2800, 0xD1D6), // 40 F0 7B F9 00 28 D6 D1 @ 4c429d6e
+        [SIG_SEC_BOOT_ENABLED_2] = SEARCH_ENTRY(0xF040, 0xF975, 0x2800, 0xD0E9), // 40 F0 75 F9 00 28 E9 D0 @ 4c429d7a
+        [SIG_UNLOCKED_STATUS_1] = SEARCH_ENTRY(0xF042, 0xFF12, 0xB148, 0x482C), // 42 F0 12 FF 48 B1 2C 48 @ 4C429D2C
+        [SIG_UNLOCKED_STATUS_2] = SEARCH_ENTRY(0xF042, 0xFEFB, 0xB1E8, 0x4821), // 42 F0 FB FE E8 B1 21 48 @ 4c429d5a
+        [SIG_AVB_CMDLINE] = SEARCH_ENTRY(0xE92D, 0x4FF0, 0x4691, 0xF102), // 2D E9 F0 4F 91 46 02 F1 @ 4c4596ac
+        [SIG_SECCFG_GET_LOCK_STATE] = SEARCH_ENTRY(0xB1D0, 0xB510, 0x4604, 0xF7FF, 0xFFDD), // @ 4c46af04
+        [SIG_GET_SBOOT_STATE] = SEARCH_ENTRY(0xB510, 0x4604, 0x2001, 0xF7FF), // @ 4c46a138
+        [SIG_CMDLINE_PRE_PROCESS] = SEARCH_ENTRY(0xF00E, 0xFABE, 0xF001, 0xF90A), // 0E F0 BE FA 01 F0 0A F9 @ 4c428184
+        [SIG_LOAD_AND_VERIFY_VBMETA] = SEARCH_ENTRY(0xF47F, 0xAE6B, 0xE688, 0xF8DD), // 7F F4 6B AE 88 E6 DD F8 @ 4c45c148
+    };
+    search_patterns(LK_START, LK_END, sigs, SIG_COUNT);
+
     // When we spoof the lock state to appear "locked", fastboot
     // starts rejecting commands with "not support on security" and
     // "not allowed in locked state" errors. Since the device is
@@ -16,37 +48,37 @@ static void spoof_lock_state(void) {
     //
     // This patch removes both security gates so fastboot commands
     // work regardless of what the spoofed lock state reports.
-    addr = SEARCH_PATTERN(LK_START, LK_END, 0xF03F, 0xFEE3, 0xB318, 0x68FB);// 3F F0 E3 FE 18 B3 FB 68 @ 4c429d1e
+    addr = sigs[SIG_USBDL_ENABLED_1].result;
     if (addr) {
         printf("Found sec_usbdl_enabled call at 0x%08X\n", addr);
         PATCH_CALL(addr, (void *)sec_usbdl_enabled, TARGET_THUMB);
     }
 
-    addr = SEARCH_PATTERN(LK_START, LK_END, 0xF03F, 0xFECC, 0xB190, 0x68FB);// 3f f0 cc fe 90 b1 fb 68 @ 4c429d4c
+    addr = sigs[SIG_USBDL_ENABLED_2].result;
     if (addr) {
         printf("Found sec_usbdl_enabled call at 0x%08X\n", addr);
         PATCH_CALL(addr, (void *)sec_usbdl_enabled, TARGET_THUMB);
     }
 
-    addr = SEARCH_PATTERN(LK_START, LK_END, 0xF040, 0xF97B, 0x2800, 0xD1D6);// 40 F0 7B F9 00 28 D6 D1 @ 4c429d6e
+    addr = sigs[SIG_SEC_BOOT_ENABLED_1].result;
     if (addr) {
         printf("Found seclib_sec_boot_enabled call at 0x%08X\n", addr);
         PATCH_CALL(addr, (void *)seclib_sec_boot_enabled, TARGET_THUMB);
     }
 
-    addr = SEARCH_PATTERN(LK_START, LK_END, 0xF040, 0xF975, 0x2800, 0xD0E9);// 40 F0 75 F9 00 28 E9 D0 @ 4c429d7a
+    addr = sigs[SIG_SEC_BOOT_ENABLED_2].result;
     if (addr) {
         printf("Found seclib_sec_boot_enabled call at 0x%08X\n", addr);
         PATCH_CALL(addr, (void *)seclib_sec_boot_enabled, TARGET_THUMB);
     }
 
-    addr = SEARCH_PATTERN(LK_START, LK_END, 0xF042, 0xFF12, 0xB148, 0x482C);// 42 F0 12 FF 48 B1 2C 48 @ 4C429D2C
+    addr = sigs[SIG_UNLOCKED_STATUS_1].result;
     if (addr) {
         printf("Found get_unlocked_status call at 0x%08X\n", addr);
         PATCH_CALL(addr, (void *)get_unlocked_status, TARGET_THUMB);
     }
 
-    addr = SEARCH_PATTERN(LK_START, LK_END, 0xF042, 0xFEFB, 0xB1E8, 0x4821);// 42 F0 FB FE E8 B1 21 48 @ 4c429d5a
+    addr = sigs[SIG_UNLOCKED_STATUS_2].result;
     if (addr) {
         printf("Found get_unlocked_status call at 0x%08X\n", addr);
         PATCH_CALL(addr, (void *)get_unlocked_status, TARGET_THUMB);
@@ -56,7 +88,7 @@ static void spoof_lock_state(void) {
     // keeps showing "unlocked" even when we want it to say "locked".
     // This patch forces the cmdline to always use the "locked"
     // string instead of checking the actual device state.
-    addr = SEARCH_PATTERN(LK_START, LK_END, 0xE92D, 0x4FF0, 0x4691, 0xF102);// 2D E9 F0 4F 91 46 02 F1 @ 4c4596ac
+    addr = sigs[SIG_AVB_CMDLINE].result;
     if (addr) {
         printf("Found AVB cmdline function at 0x%08X\n", addr);
 
@@ -68,7 +100,7 @@ static void spoof_lock_state(void) {
     // Need to spoof the LKS_STATE as "locked" for certain scenarios, but still
     // return success so other parts of the system don't freak out. This makes
     // seccfg_get_lock_state always report lock_state=1 and return 2.
-    addr = SEARCH_PATTERN(LK_START, LK_END, 0xB1D0, 0xB510, 0x4604, 0xF7FF, 0xFFDD);// @ 4c46af04
+    addr = sigs[SIG_SECCFG_GET_LOCK_STATE].result;
     if (addr) {
         printf("Found seccfg_get_lock_state at 0x%08X\n", addr);
         PATCH_MEM(addr + 6, 
@@ -92,7 +124,7 @@ static void spoof_lock_state(void) {
     // Force the secure boot state to ATTR_SBOOT_ENABLE (0x11). This controls whether
     // secure boot verification is enabled and is separate from the LKS_STATE above.
     // Setting it to 0x11 indicates secure boot is properly enabled.
-    addr = SEARCH_PATTERN(LK_START, LK_END, 0xB510, 0x4604, 0x2001, 0xF7FF);// @ 4c46a138
+    addr = sigs[SIG_GET_SBOOT_STATE].result;
     if (addr) {
         printf("Found get_sboot_state at 0x%08X\n", addr);
         PATCH_MEM(addr,
@@ -105,7 +137,7 @@ static void spoof_lock_state(void) {
 
     // Hook cmdline_pre_process so handle_recovery_boot() can flip
     // verifiedbootstate before LK hands the cmdline to the kernel.
-    addr = SEARCH_PATTERN(LK_START, LK_END, 0xF00E, 0xFABE, 0xF001, 0xF90A);// 0E F0 BE FA 01 F0 0A F9 @ 4c428184
+    addr = sigs[SIG_CMDLINE_PRE_PROCESS].result;
     if (addr) {
         printf("Found cmdline_pre_process at 0x%08X\n", addr);
         PATCH_CALL(addr, (void *)handle_recovery_boot, TARGET_THUMB);
@@ -117,7 +149,7 @@ static void spoof_lock_state(void) {
     // reject the boot if the key doesn't match, causing the "Public key
     // used to sign data rejected" error. We patch both checks so any
     // key is accepted regardless.
-    addr = SEARCH_PATTERN(LK_START, LK_END, 0xF47F, 0xAE6B, 0xE688, 0xF8DD);// 7F F4 6B AE 88 E6 DD F8 @ 4c45c148
+    addr = sigs[SIG_LOAD_AND_VERIFY_VBMETA].result;
     if (addr) {
         printf("Found load_and_verify_vbmeta at 0x%08X\n", addr);
 
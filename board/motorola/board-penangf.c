@@ -5,6 +5,7 @@
 //
 
 #include <board_ops.h>
+#include <uart/mtk_uart.h>
 
 #define VOLUME_UP 17
 #define VOLUME_DOWN 1
@@ -135,18 +136,22 @@ static int fastboot_ui(void* arg) {
     video_clean_screen();
     video_center();
     fb_set_text_scale(2);
+    fb_set_update_hook(mt_disp_update);
     fb_clear(FB_BLACK);
 
     g_fb_ui_idx = 0;
     g_spoof_status = is_spoofing_enabled() ? "1" : "0";
     fastboot_ui_info();
-    mt_disp_update(0, 0, CONFIG_FRAMEBUFFER_WIDTH, CONFIG_FRAMEBUFFER_HEIGHT);
+    fb_update_display();
 
     mdelay(1500);
 
     for (;;) {
+        // Only the info block is redrawn, so only that part of the
+        // screen gets flushed and pushed to the panel.
         fastboot_ui_info();
-        mt_disp_update(0, 0, CONFIG_FRAMEBUFFER_WIDTH, CONFIG_FRAMEBUFFER_HEIGHT);
+        fb_update_display();
+        mtk_uart_poll();
 
         if (mtk_detect_key(VOLUME_UP)) {
             g_fb_ui_idx = (g_fb_ui_idx + fb_ui_options_count - 1) % fb_ui_options_count;
@@ -186,6 +191,9 @@ static int fastboot_ui(void* arg) {
                 case FB_OPTION_KAERU_INFO:
                     video_center();
                     print_kaeru_info(video_printf);
+                    // LK draws this on its own, so the framebuffer library
+                    // doesn't know it has to be pushed to the panel.
+                    fb_mark_dirty(0, 0, CONFIG_FRAMEBUFFER_WIDTH, CONFIG_FRAMEBUFFER_HEIGHT);
                     break;
 
                 default:
@@ -1,7 +1,95 @@
 #include "mtk_uart.h"
 
+#ifdef CONFIG_UART_TX_BUFFER
+
+#define TX_SIZE CONFIG_UART_TX_BUFFER_SIZE
+
+// Output is queued here and moved to the hardware FIFO in bursts
+// whenever it has drained, from putc() and from mtk_uart_poll(). The
+// tail of a message stays here until one of those runs again, which
+// is why boards call mtk_uart_poll() from their idle loops.
+static uint8_t tx_ring[TX_SIZE];
+static uint32_t tx_head = 0; // Next free slot.
+static uint32_t tx_tail = 0; // Next byte to send.
+
+// LK threads can preempt each other mid-printf, so the ring is only
+// touched with interrupts off. That's never held while waiting on the
+// hardware, only for a single burst.
+static inline uint32_t tx_lock(void) {
+    uint32_t cpsr;
+    asm volatile("mrs %0, cpsr\n\tcpsid i" : "=r"(cpsr) :: "memory");
+    return cpsr;
+}
+
+static inline void tx_unlock(uint32_t cpsr) {
+    asm volatile("msr cpsr_c, %0" :: "r"(cpsr) : "memory");
+}
+
+// THRE with the FIFO enabled means the whole TX FIFO is empty, so it
+// can take a full FIFO's worth of bytes without checking again. Has to
+// be called with the lock held.
+static void tx_burst(void) {
+    if (tx_head == tx_tail || !(readl(UART_LSR) & UART_LSR_THRE))
+        return;
+
+    for (uint32_t n = 0; n < CONFIG_UART_FIFO_DEPTH && tx_tail != tx_head; n++) {
+        writel(tx_ring[tx_tail], UART_THR);
+        tx_tail = tx_tail + 1 == TX_SIZE ? 0 : tx_tail + 1;
+    }
+}
+
+void mtk_uart_putc(int ch) {
+    for (;;) {
+        uint32_t cpsr = tx_lock();
+        uint32_t next = tx_head + 1 == TX_SIZE ? 0 : tx_head + 1;
+
+        if (next != tx_tail) {
+            tx_ring[tx_head] = ch;
+            tx_head = next;
+            tx_burst();
+            tx_unlock(cpsr);
+            return;
+        }
+
+        // Full, give interrupts a chance while the UART catches up.
+        tx_burst();
+        tx_unlock(cpsr);
+    }
+}
+
+// Never waits, moves whatever fits into the FIFO right now. Cheap
+// enough to call from any loop that has nothing better to do.
+void mtk_uart_poll(void) {
+    uint32_t cpsr = tx_lock();
+    tx_burst();
+    tx_unlock(cpsr);
+}
+
+// Waits until everything queued is out on the wire. Has to run before
+// LK gets the UART back and before the SoC resets.
+void mtk_uart_flush(void) {
+    for (;;) {
+        uint32_t cpsr = tx_lock();
+        uint32_t queued;
+
+        tx_burst();
+        queued = tx_head != tx_tail;
+        tx_unlock(cpsr);
+
+        if (!queued)
+            break;
+    }
+
+    while (!(readl(UART_LSR) & UART_LSR_TEMT))
+        ;
+}
+
+#else
+
 void mtk_uart_putc(int ch) {
     while (!(readl(UART_LSR) & UART_LSR_THRE))
         ;
     writel(ch, UART_THR);
-}
\ No newline at end of file
+}
+
+#endif
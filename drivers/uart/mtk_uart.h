@@ -6,5 +6,14 @@
 #define UART_LSR    (CONFIG_UART_BASE + 0x14)
 
 #define UART_LSR_THRE   BIT(5)
+#define UART_LSR_TEMT   BIT(6)
 
-void mtk_uart_putc(int ch);
\ No newline at end of file
+void mtk_uart_putc(int ch);
+
+#ifdef CONFIG_UART_TX_BUFFER
+void mtk_uart_poll(void);
+void mtk_uart_flush(void);
+#else
+static inline void mtk_uart_poll(void) {}
+static inline void mtk_uart_flush(void) {}
+#endif
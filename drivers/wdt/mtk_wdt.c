@@ -1,6 +1,11 @@
 #include "mtk_wdt.h"
 
+#include <uart/mtk_uart.h>
+
 void mtk_wdt_reset(void) {
+    /* don't lose the last lines of the log to the reset */
+    mtk_uart_flush();
+
     /* first kick the watchdog to ensure it's alive */
     writel(MTK_WDT_RESTART_KEY, MTK_WDT_RESTART);
 
@@ -24,4 +29,9 @@ void mtk_wdt_disable(void) {
 
     /* write back to disable the watchdog */
     writel(mode, MTK_WDT_MODE);
-}
\ No newline at end of file
+}
+
+uint32_t mtk_wdt_status(void) {
+    /* why the last reset happened, only meaningful after a warm one */
+    return readl(MTK_WDT_STATUS);
+}
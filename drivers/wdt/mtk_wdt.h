@@ -18,9 +18,14 @@
 #define MTK_WDT_MODE_AUTO_RESTART BIT(4)
 #define MTK_WDT_MODE_DUAL_MODE    BIT(6)
 
+#define MTK_WDT_STATUS_HWWDT_RST  BIT(31)
+#define MTK_WDT_STATUS_SWWDT_RST  BIT(30)
+#define MTK_WDT_STATUS_IRQWDT_RST BIT(29)
+
 #define MTK_WDT_LENGTH_KEY   0x08
 #define MTK_WDT_RESTART_KEY  0x1971
 #define MTK_WDT_SWRST_KEY   0x1209
 
 void mtk_wdt_reset(void);
-void mtk_wdt_disable(void);
\ No newline at end of file
+void mtk_wdt_disable(void);
+uint32_t mtk_wdt_status(void);
\ No newline at end of file
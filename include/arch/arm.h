@@ -10,8 +10,17 @@
 #include <stddef.h>
 
 #include <arch/cache.h>
+#include <lib/patch.h>
 #include <lib/string.h>
 
+#ifdef CONFIG_BL_INDEX
+#include <lib/bl_index.h>
+#endif
+
+#ifdef CONFIG_SEARCH_CACHE
+#include <lib/search.h>
+#endif
+
 #define ARM_MODE(lr) ((lr)&1 ? "THUMB" : "ARM")
 #define READ_SP(var) asm volatile("mov %0, sp" : "=r"(var))
 #define READ_LR(var) asm volatile("mov %0, lr" : "=r"(var))
@@ -48,7 +57,7 @@ typedef enum { TARGET_THUMB, TARGET_ARM } arm_mode_t;
         volatile uint16_t* p = (volatile uint16_t*)(addr);                         \
         *p = hi_inst;                                                              \
         *(p + 1) = lo_inst;                                                        \
-        arch_sync_cache_range((uint32_t)(addr), 4);                                \
+        patch_sync_range((uint32_t)(addr), 4);                                     \
     } while (0)
 
 #define PATCH_BRANCH(addr, func)                           \
@@ -63,10 +72,10 @@ typedef enum { TARGET_THUMB, TARGET_ARM } arm_mode_t;
         volatile uint16_t* p = (volatile uint16_t*)(addr); \
         *p = hi_inst;                                      \
         *(p + 1) = lo_inst;                                \
-        arch_sync_cache_range((uint32_t)(addr), 4);        \
+        patch_sync_range((uint32_t)(addr), 4);             \
     } while (0)
 
-#define PATCH_ALL_BL(func_addr, size, orig_func, hook)                    \
+#define PATCH_ALL_BL_SCAN(func_addr, size, orig_func, hook)               \
     ({                                                                    \
         int _count = 0;                                                   \
         uint32_t _start = (uint32_t)(func_addr);                          \
@@ -85,6 +94,22 @@ typedef enum { TARGET_THUMB, TARGET_ARM } arm_mode_t;
         _count;                                                           \
     })
 
+// With the BL index built over the range, only the known callers of
+// orig_func are looked at instead of decoding every halfword.
+#ifdef CONFIG_BL_INDEX
+#define PATCH_ALL_BL(func_addr, size, orig_func, hook)                    \
+    ({                                                                    \
+        uint32_t _s = (uint32_t)(func_addr);                              \
+        int _n = bl_index_patch(_s, _s + (size), (uint32_t)(orig_func),   \
+                                (uint32_t)(hook));                        \
+        if (_n < 0)                                                       \
+            _n = PATCH_ALL_BL_SCAN(func_addr, size, orig_func, hook);     \
+        _n;                                                               \
+    })
+#else
+#define PATCH_ALL_BL PATCH_ALL_BL_SCAN
+#endif
+
 #define PATCH_MEM(addr, ...)                                                      \
     do {                                                                          \
         const uint16_t patch_data[] = {__VA_ARGS__};                              \
@@ -92,7 +117,7 @@ typedef enum { TARGET_THUMB, TARGET_ARM } arm_mode_t;
         for (size_t i = 0; i < sizeof(patch_data) / sizeof(patch_data[0]); i++) { \
             p[i] = patch_data[i];                                                 \
         }                                                                         \
-        arch_sync_cache_range((uint32_t)(addr), sizeof(patch_data));              \
+        patch_sync_range((uint32_t)(addr), sizeof(patch_data));                   \
     } while (0)
 
 #define PATCH_MEM_ARM(addr, ...)                                                  \
@@ -102,9 +127,16 @@ typedef enum { TARGET_THUMB, TARGET_ARM } arm_mode_t;
         for (size_t i = 0; i < sizeof(patch_data) / sizeof(patch_data[0]); i++) { \
             p[i] = patch_data[i];                                                 \
         }                                                                         \
-        arch_sync_cache_range((uint32_t)(addr), sizeof(patch_data));              \
+        patch_sync_range((uint32_t)(addr), sizeof(patch_data));                   \
     } while (0)
 
+#ifdef CONFIG_SEARCH_CACHE
+// Every lookup goes through the search cache, so the ones made from
+// late init onwards are checked in place instead of scanned for on
+// the next boot with the same LK.
+#define SEARCH_PATTERN(start_addr, end_addr, ...) \
+    SEARCH_PATTERN_CACHED((start_addr), (end_addr), __VA_ARGS__)
+#else
 #define SEARCH_PATTERN(start_addr, end_addr, ...)                            \
     ({                                                                       \
         static uint16_t pattern[] = {__VA_ARGS__};                           \
@@ -132,6 +164,7 @@ typedef enum { TARGET_THUMB, TARGET_ARM } arm_mode_t;
                                                                              \
         result;                                                              \
     })
+#endif
 
 #define SEARCH_PATTERN_ARM(start_addr, end_addr, ...)                        \
     ({                                                                       \
@@ -176,7 +209,7 @@ typedef enum { TARGET_THUMB, TARGET_ARM } arm_mode_t;
         volatile uint16_t* p = (volatile uint16_t*)(addr);    \
         for (int i = 0; i < (count); i++)                     \
             p[i] = 0xBF00;                                    \
-        arch_sync_cache_range((uint32_t)(addr), (count) * 2); \
+        patch_sync_range((uint32_t)(addr), (count) * 2);      \
     } while (0)
 
 #define NOP_ARM(addr, count)                                  \
@@ -184,5 +217,5 @@ typedef enum { TARGET_THUMB, TARGET_ARM } arm_mode_t;
         volatile uint32_t* p = (volatile uint32_t*)(addr);    \
         for (int i = 0; i < (count); i++)                     \
             p[i] = 0xE320F000;                                \
-        arch_sync_cache_range((uint32_t)(addr), (count) * 4); \
+        patch_sync_range((uint32_t)(addr), (count) * 4);      \
     } while (0)
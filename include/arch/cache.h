@@ -15,6 +15,7 @@
 void arch_clean_cache_range(uintptr_t start, size_t len);
 void arch_clean_invalidate_cache_range(uintptr_t start, size_t len);
 void arch_sync_cache_range(uintptr_t start, uint32_t size);
+void arch_invalidate_icache(void);
 
 uint32_t enable_unaligned(void);
 void restore_unaligned(uint32_t prev);
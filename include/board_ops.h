@@ -13,8 +13,10 @@
 #include <lib/common.h>
 #include <lib/debug.h>
 #include <lib/fastboot.h>
+#include <lib/profiler.h>
 #include <lib/security/seccfg.h>
 #include <lib/recovery.h>
+#include <lib/search.h>
 #include <lib/string.h>
 #include <lib/thread.h>
 
@@ -34,6 +36,10 @@
 #include <lib/framebuffer.h>
 #endif
 
+#ifdef CONFIG_HEAP_SUPPORT
+#include <lib/heap.h>
+#endif
+
 #ifdef CONFIG_SPOOF_SUPPORT
 #include <lib/spoof.h>
 #endif
@@ -42,5 +48,9 @@
 #include <lib/storage.h>
 #endif
 
+#ifdef CONFIG_XREF_SUPPORT
+#include <lib/xref.h>
+#endif
+
 void board_early_init(void);
 void board_late_init(void);
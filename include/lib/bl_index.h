@@ -0,0 +1,18 @@
+//
+// SPDX-FileCopyrightText: 2026 Roger Ortiz <roger@r0rt1z2.com>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+
+#pragma once
+
+#include <stdint.h>
+
+// Index of every Thumb-2 BL in a range of LK, built once in early init
+// so PATCH_ALL_BL becomes a binary search instead of a full decode of
+// the range. Entries describe LK as it was when the index was built;
+// patching re-checks the live instruction, so sites patched since then
+// are skipped on their own. Freed once board_late_init() is done.
+void bl_index_init(void);
+int bl_index_build(uint32_t start, uint32_t end);
+void bl_index_free(void);
+int bl_index_patch(uint32_t start, uint32_t end, uint32_t orig, uint32_t hook);
@@ -12,6 +12,7 @@
 
 #define KAERU_ENV_BLDR_SPOOF "kaeru_bootloader_spoof_status"
 #define KAERU_ENV_UART_ENABLE "kaeru_uart_enable"
+#define KAERU_ENV_SEARCH_CACHE "kaeru_search_cache"
 
 #define ARRAY_SIZE(arr) (sizeof(arr) / sizeof((arr)[0]))
 
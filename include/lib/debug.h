@@ -7,8 +7,20 @@
 
 #include <stddef.h>
 #include <stdarg.h>
+#include <stdint.h>
 
 #include <lib/nanoprintf.h>
+#include <lib/trace.h>
+
+// Where printf() output goes. Every message is formatted once and then
+// passed to each registered sink in blocks of up to 128 bytes, which
+// don't necessarily end on a newline.
+typedef void (*log_sink_t)(const char* buf, size_t len);
+
+#define LOG_SINK_MAX 4
+
+int log_sink_register(log_sink_t sink);
+void log_sink_unregister(log_sink_t sink);
 
 int printf(const char* fmt, ...);
 int video_printf(const char* fmt, ...);
@@ -16,10 +28,27 @@ int video_printf(const char* fmt, ...);
 #ifdef CONFIG_FRAMEBUFFER_SUPPORT
 int fb_printf(const char* fmt, ...);
 int fb_vprintf(const char *fmt, va_list args);
+void fb_log_sink(const char* buf, size_t len);
 void fb_hexdump(const void* data, size_t size);
-void fb_update_display(void);
 #endif
 
+#define HEXDUMP_LINE 16
+
+// For regions that can't be mapped in one go, like a partition read a
+// block at a time: feed the data in pieces of any size with
+// hexdump_write() and the output is the same as one hexdump() of it
+// all, with addresses counted from the one given to hexdump_begin().
+typedef struct {
+    int (*out)(const char *, ...);
+    uint64_t addr;
+    uint8_t buf[HEXDUMP_LINE];
+    size_t len;
+} hexdump_stream_t;
+
+void hexdump_begin(hexdump_stream_t* s, uint64_t addr, int (*out)(const char *, ...));
+void hexdump_write(hexdump_stream_t* s, const void* data, size_t size);
+void hexdump_end(hexdump_stream_t* s);
+
 void hexdump(const void* data, size_t size, int (*out)(const char *, ...));
 void uart_hexdump(const void* data, size_t size);
 void video_hexdump(const void* data, size_t size);
\ No newline at end of file
@@ -19,4 +19,10 @@ void fastboot_fail(const char* reason);
 void fastboot_okay(const char* reason);
 void fastboot_register(const char* prefix, void (*handle)(const char* arg, void* data, unsigned sz),
                        unsigned char security_enabled);
-void fastboot_publish(const char* name, const char* value);
\ No newline at end of file
+void fastboot_publish(const char* name, const char* value);
+
+// Most bytes fastboot_info_base64() can send in one INFO line, so the
+// encoded text plus "INFO" still fits LK's 64 byte response buffer.
+#define FASTBOOT_BASE64_MAX 42
+
+void fastboot_info_base64(const void* data, unsigned len);
\ No newline at end of file
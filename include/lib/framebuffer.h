@@ -36,20 +36,76 @@
 #define FB_OLIVE         0xFF808000
 #define FB_TEAL          0xFF008080
 
+// Extra pixels between two lines of text.
+#define FB_LINE_SPACING  4
+
+typedef struct {
+    uint32_t x;
+    uint32_t y;
+    uint32_t w;
+    uint32_t h;
+} fb_rect_t;
+
+// 8x8 bitmap font, one byte per row. Fonts differ in which bit holds
+// the leftmost column and in which characters they cover.
+typedef struct {
+    const uint8_t (*glyphs)[8];
+    uint8_t first;
+    uint8_t count;
+    bool msb_first;
+} fb_font_t;
+
+extern const fb_font_t fb_font;
+
+// Palette + RLE image, as generated by utils/image.py. The data is a
+// stream of packets, each starting with a control byte:
+//
+//   0nnnnnnn i       n + 1 pixels of palette colour i
+//   1nnnnnnn i ...   n + 1 pixels, one palette index each
+//
+// Packets never cross a row. Palette entries are ARGB8888, and those
+// with an alpha of zero are transparent, i.e. not drawn at all.
 typedef struct {
-    uint32_t *buffer;
-    uint32_t width;
+    uint16_t width;
+    uint16_t height;
+    uint16_t colors;
+    const uint32_t *palette;
+    const uint8_t *data;
+    uint32_t size;
+} fb_image_t;
+
+typedef void (*fb_update_hook_t)(uint32_t x, uint32_t y, uint32_t w, uint32_t h);
+
+typedef struct {
+    void *buffer;   // Where drawing goes, the back buffer if there is one.
+    void *scanout;  // What the display controller reads from.
+    uint32_t width;       // Drawing area, after rotation.
     uint32_t height;
+    uint32_t phys_width;  // The panel, as it scans out.
+    uint32_t phys_height;
+    uint32_t rotation;    // Clockwise, in degrees: 0, 90, 180 or 270.
     uint32_t bppx;
     uint32_t stride;
 } fb_config_t;
 
-void fb_init(uint32_t *fb_addr, uint32_t width, uint32_t height, uint32_t bppx, uint32_t alignment);
+void fb_init(void *fb_addr, uint32_t width, uint32_t height, uint32_t bppx, uint32_t alignment);
 void fb_clear(uint32_t color);
 void fb_pixel(uint32_t x, uint32_t y, uint32_t color);
+void fb_hline(uint32_t x, uint32_t y, uint32_t w, uint32_t color);
+void fb_vline(uint32_t x, uint32_t y, uint32_t h, uint32_t color);
 void fb_rect(uint32_t x, uint32_t y, uint32_t w, uint32_t h, uint32_t color);
 void fb_fill_rect(uint32_t x, uint32_t y, uint32_t w, uint32_t h, uint32_t color);
 void fb_rounded_rect(uint32_t x, uint32_t y, uint32_t w, uint32_t h, uint32_t radius, uint32_t color);
+void fb_fill_rounded_rect(uint32_t x, uint32_t y, uint32_t w, uint32_t h, uint32_t radius, uint32_t color);
+void fb_circle(uint32_t cx, uint32_t cy, uint32_t r, uint32_t color);
+void fb_fill_circle(uint32_t cx, uint32_t cy, uint32_t r, uint32_t color);
+void fb_line(uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1, uint32_t color);
+void fb_triangle(uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1,
+                 uint32_t x2, uint32_t y2, uint32_t color);
+void fb_fill_triangle(uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1,
+                      uint32_t x2, uint32_t y2, uint32_t color);
+void fb_fill_triangle_rounded(uint32_t cx, uint32_t top_y, uint32_t size,
+                              uint32_t radius, uint32_t color);
 void fb_arrow_right(uint32_t x, uint32_t y, uint32_t size, uint32_t color);
 
 void fb_char(uint32_t x, uint32_t y, char c, uint32_t color);
@@ -73,6 +129,29 @@ void fb_cursor_home(void);
 
 bool fb_valid(uint32_t x, uint32_t y);
 fb_config_t *fb_get_config(void);
+void fb_set_rotation(uint32_t degrees);
+uint32_t fb_get_rotation(void);
 uint32_t fb_rgb(uint8_t r, uint8_t g, uint8_t b);
 
+void fb_scroll(uint32_t dy, uint32_t color);
+
+#ifdef CONFIG_FRAMEBUFFER_CONSOLE
+void fb_console_putc(char c);
+void fb_console_newline(void);
+void fb_console_scroll(int lines);
+void fb_console_init(void);
+#endif
+
+void fb_mark_dirty(uint32_t x, uint32_t y, uint32_t w, uint32_t h);
+void fb_set_update_hook(fb_update_hook_t hook);
+void fb_update_display(void);
+
+#ifdef CONFIG_FRAMEBUFFER_SCREENSHOT
+void fb_screenshot_init(void);
+#endif
+
+#ifdef CONFIG_FRAMEBUFFER_IMAGE
+void fb_blit_rle(uint32_t x, uint32_t y, const fb_image_t *img, uint32_t scale);
+#endif
+
 void fb_warning_icon(uint32_t cx, uint32_t y, uint32_t size);
\ No newline at end of file
@@ -0,0 +1,11 @@
+//
+// SPDX-FileCopyrightText: 2026 Roger Ortiz <roger@r0rt1z2.com>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+
+#pragma once
+
+#include <stddef.h>
+
+void* malloc(size_t size);
+void free(void* ptr);
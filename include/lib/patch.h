@@ -0,0 +1,24 @@
+//
+// SPDX-FileCopyrightText: 2026 Roger Ortiz <roger@r0rt1z2.com>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Patch transactions.
+//
+// Between patch_begin() and patch_commit(), the PATCH_* and NOP
+// macros still write straight to memory and clean it out of the data
+// cache, but the icache invalidate they need is deferred. Commit then
+// invalidates the icache a single time, instead of once per patch.
+//
+// Nothing patched inside a transaction may run before it's committed.
+// Code that has to call into something it just patched can use
+// patch_flush() to sync early without closing the transaction.
+void patch_begin(void);
+void patch_commit(void);
+void patch_flush(void);
+void patch_sync_range(uintptr_t start, size_t size);
@@ -0,0 +1,24 @@
+//
+// SPDX-FileCopyrightText: 2026 Roger Ortiz <roger@r0rt1z2.com>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Boot timeline built from the PMU cycle counter. Each mark starts a
+// phase that lasts until the next one, so the last mark only closes
+// the previous phase. Phases flagged as 'lk' are spent in the original
+// bootloader and don't count towards kaeru's total.
+void profiler_mark(const char* name, bool lk);
+void profiler_publish(void);
+
+#ifdef CONFIG_BOOT_PROFILER
+#define PROFILE_MARK(name) profiler_mark((name), false)
+#define PROFILE_MARK_LK(name) profiler_mark((name), true)
+#else
+#define PROFILE_MARK(name) do {} while (0)
+#define PROFILE_MARK_LK(name) do {} while (0)
+#endif
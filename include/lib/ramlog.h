@@ -0,0 +1,26 @@
+//
+// SPDX-FileCopyrightText: 2026 Roger Ortiz <roger@r0rt1z2.com>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+
+#pragma once
+
+#include <stdint.h>
+
+// Log kept in reserved DRAM, which survives a warm reboot. The region
+// holds two slots: this boot writes to one while the other keeps the
+// previous boot's log, so 'fastboot oem lastlog' can show how it
+// ended even if kaeru crashed or hung before anything reached UART.
+#define RAMLOG_MAGIC 0x474C524B // "KRLG"
+
+typedef struct {
+    uint32_t magic;
+    uint32_t boot;   // Sequence number, one more than the previous boot.
+    uint32_t size;   // Bytes of log data following the header.
+    uint32_t head;   // Bytes ever written, the ring wraps at size.
+    uint32_t crc;    // CRC-32 of the fields above.
+    uint32_t reserved[3];
+} ramlog_header_t;
+
+void ramlog_init(void);
+void ramlog_publish(void);
@@ -0,0 +1,97 @@
+//
+// SPDX-FileCopyrightText: 2026 Roger Ortiz <roger@r0rt1z2.com>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Maximum number of signatures a single search_patterns() call can
+// resolve. Boards with more than this should split them in batches.
+#define SEARCH_BATCH_MAX 64
+
+// A halfword that only has to match on the bits set in mask. Handy
+// for skipping over BL offsets or registers that change between LK
+// builds, the same way 'XX' works in utils/parse.py.
+typedef struct {
+    uint16_t value;
+    uint16_t mask;
+} search_mask_t;
+
+#define HW_EXACT(v) {(uint16_t)(v), 0xFFFF}
+#define HW_MASK(v, m) {(uint16_t)((v) & (m)), (uint16_t)(m)}
+#define HW_ANY {0, 0}
+
+// Any Thumb-2 BL, regardless of where it points to.
+#define HW_BL HW_MASK(0xF000, 0xF800), HW_MASK(0xD000, 0xD000)
+
+typedef struct {
+    const uint16_t* pattern;
+    const search_mask_t* masked;
+    uint32_t count;
+    uint32_t result;
+} search_pattern_t;
+
+// Declares a batch entry from the same halfword list SEARCH_PATTERN
+// takes, e.g.:
+//
+//   search_pattern_t sigs[] = {
+//       [SIG_VFY_POLICY] = SEARCH_ENTRY(0xB508, 0xF7FF, 0xFF67, 0xF3C0),
+//       [SIG_DL_POLICY]  = SEARCH_ENTRY_MASKED(HW_EXACT(0xB508), HW_BL, HW_EXACT(0xF000)),
+//   };
+//   search_patterns(LK_START, LK_END, sigs, ARRAY_SIZE(sigs));
+//
+// Each entry's result is set to the first match, or left at 0.
+#define SEARCH_ENTRY(...)                                                    \
+    {                                                                        \
+        .pattern = (const uint16_t[]){__VA_ARGS__},                          \
+        .masked = NULL,                                                      \
+        .count = sizeof((const uint16_t[]){__VA_ARGS__}) / sizeof(uint16_t), \
+        .result = 0,                                                         \
+    }
+
+#define SEARCH_ENTRY_MASKED(...)                                                       \
+    {                                                                                  \
+        .pattern = NULL,                                                               \
+        .masked = (const search_mask_t[]){__VA_ARGS__},                                \
+        .count = sizeof((const search_mask_t[]){__VA_ARGS__}) / sizeof(search_mask_t), \
+        .result = 0,                                                                   \
+    }
+
+// Same as SEARCH_PATTERN, but takes HW_EXACT/HW_MASK/HW_ANY/HW_BL
+// entries instead of plain halfwords.
+#define SEARCH_PATTERN_MASKED(start_addr, end_addr, ...)                           \
+    ({                                                                             \
+        static const search_mask_t _masked[] = {__VA_ARGS__};                      \
+        search_pattern_masked((start_addr), (end_addr), _masked,                  \
+                              sizeof(_masked) / sizeof(_masked[0]));               \
+    })
+
+// A single signature through search_patterns(), and so through the
+// search cache: once that is loaded (late init onwards), a warm boot
+// skips the scan. With CONFIG_SEARCH_CACHE, SEARCH_PATTERN is this.
+#define SEARCH_PATTERN_CACHED(start_addr, end_addr, ...)                          \
+    ({                                                                            \
+        search_pattern_t _p = SEARCH_ENTRY(__VA_ARGS__);                          \
+        search_patterns((start_addr), (end_addr), &_p, 1);                        \
+        _p.result;                                                                \
+    })
+
+int search_patterns(uint32_t start, uint32_t end, search_pattern_t* patterns, size_t count);
+uint32_t search_pattern_masked(uint32_t start, uint32_t end,
+                               const search_mask_t* pattern, size_t count);
+
+#ifdef CONFIG_SEARCH_CACHE
+void search_cache_init(void);
+void search_cache_load(void);
+void search_cache_save(void);
+uint32_t search_cache_key(const search_pattern_t* p, uint32_t start);
+uint32_t search_cache_get(uint32_t key);
+void search_cache_put(uint32_t key, uint32_t addr);
+#else
+static inline uint32_t search_cache_key(const search_pattern_t* p, uint32_t start) { (void)p; (void)start; return 0; }
+static inline uint32_t search_cache_get(uint32_t key) { (void)key; return 0; }
+static inline void search_cache_put(uint32_t key, uint32_t addr) { (void)key; (void)addr; }
+#endif
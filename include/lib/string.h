@@ -37,15 +37,15 @@
 
 /* derived from optimized ASM */
 void *memchr(const void *s, int c, size_t n);
+int memcmp(const void *s1, const void *s2, size_t n);
 void *memcpy(void *dest, const void *src, size_t n);
+void *memmove(void *dest, const void *src, size_t n);
 void *memset(void *dst, int c, size_t n);
+size_t strlen(const char *s);
 
-int memcmp(const void* s1, const void* s2, size_t n);
-void* memmove(void* dest, const void* src, size_t count);
 void *memmem(const void *haystack, size_t hlen, const void *needle, size_t nlen);
 int strcmp(const char* s1, const char* s2);
 char* strchr(const char* s, int c);
-size_t strlen(const char* str);
 size_t strnlen(char const *s, size_t count);
 int strncmp(const char* s1, const char* s2, size_t n);
 char* strstr(const char* h, const char* n);
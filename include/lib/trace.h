@@ -0,0 +1,41 @@
+//
+// SPDX-FileCopyrightText: 2026 Roger Ortiz <roger@r0rt1z2.com>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+
+#pragma once
+
+#include <stdint.h>
+
+// Binary trace. TRACE() takes a printf style format and up to seven
+// 32-bit arguments, but formats nothing: it stores where the format
+// lives and the raw arguments in a RAM ring. 'fastboot oem trace'
+// dumps the ring and utils/trace.py turns it back into text using
+// kaeru.o, which is the only place the format strings end up in.
+//
+// %s arguments are only resolved if they point into kaeru itself, and
+// 64-bit arguments aren't supported.
+#define TRACE_MAX_ARGS 7
+
+void trace_record(uint32_t id, uint32_t nargs, ...);
+void trace_init(void);
+
+#define TRACE_NARGS(...) TRACE_NARGS_(0, ##__VA_ARGS__, 7, 6, 5, 4, 3, 2, 1, 0)
+#define TRACE_NARGS_(_0, _1, _2, _3, _4, _5, _6, _7, n, ...) n
+
+#ifdef CONFIG_TRACE
+// .trace_fmt is linked at address 0 and not loaded, so the link time
+// address of a format is its offset in the section and costs nothing
+// at runtime. trace_record() takes the load offset back out of it.
+#define TRACE(fmt, ...)                                                       \
+    do {                                                                      \
+        static const char _trace_fmt[]                                        \
+            __attribute__((section(".trace_fmt"), used)) = fmt;               \
+        _Static_assert(TRACE_NARGS(__VA_ARGS__) <= TRACE_MAX_ARGS,            \
+                       "too many TRACE() arguments");                         \
+        trace_record((uint32_t)_trace_fmt, TRACE_NARGS(__VA_ARGS__),          \
+                     ##__VA_ARGS__);                                          \
+    } while (0)
+#else
+#define TRACE(fmt, ...) do { if (0) printf(fmt, ##__VA_ARGS__); } while (0)
+#endif
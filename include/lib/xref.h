@@ -0,0 +1,39 @@
+//
+// SPDX-FileCopyrightText: 2026 Roger Ortiz <roger@r0rt1z2.com>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <lib/common.h>
+
+// Maximum number of targets a single xref_resolve() call can handle.
+#define XREF_BATCH_MAX 32
+
+typedef struct {
+    uint32_t target; // Address being referenced, i.e. a string in LK.
+    uint32_t ref;    // First instruction that materializes it, or 0.
+    uint32_t pool;   // Literal pool word it was loaded from, if any.
+    uint32_t func;   // Start of the function holding ref, or 0.
+} xref_query_t;
+
+int xref_resolve(uint32_t start, uint32_t end, xref_query_t* queries, size_t count);
+uint32_t xref_func_start(uint32_t addr, uint32_t limit);
+uint32_t xref_func_by_addr(uint32_t target);
+
+// Finds the function that uses a given string, e.g.:
+//
+//   uint32_t addr = XREF_FUNC_BY_STRING("[%s] seccfg lock state: %d\n");
+//
+// The terminator is part of the search, so the string has to match
+// in full rather than just be the prefix of a longer one.
+#define XREF_FUNC_BY_STRING(lit)                                            \
+    ({                                                                      \
+        void* _s = memmem((void*)(uintptr_t)LK_START,                       \
+                          (size_t)(LK_END - LK_START),                      \
+                          (lit), sizeof(lit));                              \
+        _s ? xref_func_by_addr((uint32_t)(uintptr_t)_s) : 0;                \
+    })
@@ -15,3 +15,12 @@
 void __attribute__((weak)) sej_init(void);
 void __attribute__((weak)) storage_init(void);
 void __attribute__((weak)) framebuffer_init(void);
+void __attribute__((weak)) bl_index_init(void);
+void __attribute__((weak)) bl_index_free(void);
+void __attribute__((weak)) search_cache_init(void);
+void __attribute__((weak)) search_cache_load(void);
+void __attribute__((weak)) search_cache_save(void);
+void __attribute__((weak)) profiler_publish(void);
+void __attribute__((weak)) trace_init(void);
+void __attribute__((weak)) ramlog_init(void);
+void __attribute__((weak)) ramlog_publish(void);
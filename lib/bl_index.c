@@ -0,0 +1,173 @@
+//
+// SPDX-FileCopyrightText: 2026 Roger Ortiz <roger@r0rt1z2.com>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+
+#include <stdbool.h>
+
+#include <arch/arm.h>
+#include <lib/bl_index.h>
+#include <lib/common.h>
+#include <lib/debug.h>
+#include <lib/heap.h>
+
+// Sites come out of the scan already in ascending order, so they only
+// need a parallel array of targets. by_target is a permutation of the
+// entries ordered by (target, site), which is what patching looks up.
+static struct {
+    uint32_t start;
+    uint32_t end;
+    uint32_t count;
+    uint32_t* sites;
+    uint32_t* targets;
+    uint32_t* by_target;
+} idx;
+
+static inline bool is_bl(uint32_t addr) {
+    uint16_t hi = *(volatile uint16_t*)addr;
+    uint16_t lo = *(volatile uint16_t*)(addr + 2);
+
+    return (hi & 0xF800) == 0xF000 && (lo & 0xD000) == 0xD000;
+}
+
+static inline bool target_less(uint32_t a, uint32_t b) {
+    if (idx.targets[a] != idx.targets[b])
+        return idx.targets[a] < idx.targets[b];
+    return a < b;
+}
+
+static void sift_down(uint32_t* perm, uint32_t root, uint32_t count) {
+    for (;;) {
+        uint32_t child = root * 2 + 1;
+
+        if (child >= count)
+            return;
+        if (child + 1 < count && target_less(perm[child], perm[child + 1]))
+            child++;
+        if (!target_less(perm[root], perm[child]))
+            return;
+
+        uint32_t tmp = perm[root];
+        perm[root] = perm[child];
+        perm[child] = tmp;
+        root = child;
+    }
+}
+
+// Heapsort, since it needs no extra memory and no recursion.
+static void sort_by_target(uint32_t* perm, uint32_t count) {
+    for (uint32_t i = count / 2; i-- > 0;)
+        sift_down(perm, i, count);
+
+    for (uint32_t end = count; end-- > 1;) {
+        uint32_t tmp = perm[0];
+        perm[0] = perm[end];
+        perm[end] = tmp;
+        sift_down(perm, 0, end);
+    }
+}
+
+// Index of the first by_target entry whose target is >= target.
+static uint32_t lower_bound_target(uint32_t target) {
+    uint32_t lo = 0, hi = idx.count;
+
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (idx.targets[idx.by_target[mid]] < target)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+void bl_index_free(void) {
+    free(idx.sites);
+    free(idx.targets);
+    free(idx.by_target);
+    idx.sites = idx.targets = idx.by_target = NULL;
+    idx.count = 0;
+}
+
+// Decodes every BL in [start, end) once. Uses the same candidate test
+// as PATCH_ALL_BL, so both see the exact same set of sites. Returns
+// the number of entries, or -1 if LK's heap couldn't fit the index.
+int bl_index_build(uint32_t start, uint32_t end) {
+    uint32_t count = 0;
+
+    bl_index_free();
+
+    for (uint32_t a = start; a < end - 2; a += 2) {
+        if (is_bl(a)) count++;
+    }
+
+    if (!count)
+        return 0;
+
+    idx.sites = malloc(count * sizeof(uint32_t));
+    idx.targets = malloc(count * sizeof(uint32_t));
+    idx.by_target = malloc(count * sizeof(uint32_t));
+
+    if (!idx.sites || !idx.targets || !idx.by_target) {
+        printf("bl_index: failed to allocate %u entries\n", count);
+        bl_index_free();
+        return -1;
+    }
+
+    for (uint32_t a = start; a < end - 2 && idx.count < count; a += 2) {
+        if (!is_bl(a)) continue;
+
+        idx.sites[idx.count] = a;
+        idx.targets[idx.count] = DECODE_BL_TARGET(a) & ~1;
+        idx.by_target[idx.count] = idx.count;
+        idx.count++;
+    }
+
+    sort_by_target(idx.by_target, idx.count);
+    idx.start = start;
+    idx.end = end;
+
+#if KAERU_DEBUG
+    printf("bl_index: %u call sites in 0x%08X-0x%08X\n", idx.count, start, end);
+#endif
+
+    return idx.count;
+}
+
+// PATCH_ALL_BL through the index. Returns -1 if [start, end) isn't
+// covered by it, so the caller can fall back to decoding the range.
+int bl_index_patch(uint32_t start, uint32_t end, uint32_t orig, uint32_t hook) {
+    int count = 0;
+
+    if (!idx.count || start < idx.start || end > idx.end)
+        return -1;
+
+    orig &= ~1;
+
+    for (uint32_t i = lower_bound_target(orig); i < idx.count; i++) {
+        uint32_t e = idx.by_target[i];
+        uint32_t site = idx.sites[e];
+
+        if (idx.targets[e] != orig)
+            break;
+        if (site < start || site >= end - 2)
+            continue;
+        if (!is_bl(site) || (DECODE_BL_TARGET(site) & ~1) != orig)
+            continue;
+
+        PATCH_CALL(site, (void*)hook, TARGET_THUMB);
+        count++;
+    }
+
+    return count;
+}
+
+void bl_index_init(void) {
+    uint32_t end = LK_START + CONFIG_BL_INDEX_SIZE;
+
+    if (!CONFIG_BL_INDEX_SIZE || end > LK_END)
+        end = LK_END;
+
+    bl_index_build(LK_START, end);
+}
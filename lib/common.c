@@ -9,10 +9,12 @@
 #include <lib/environment.h>
 #include <lib/fastboot.h>
 
+#include <uart/mtk_uart.h>
 #include <wdt/mtk_wdt.h>
 #include <usbdl/mtk_usbdl.h>
 
 void reboot_emergency(void) {
+    mtk_uart_flush();
     mtk_reboot_emergency();
 }
 
@@ -15,33 +15,105 @@
 
 #include <uart/mtk_uart.h>
 
-void uart_putc(int c, void* ctx) {
-    (void)ctx;
-    
-    if (c == '\n')
-        mtk_uart_putc('\r');
-    
-    mtk_uart_putc(c);
+// Formatted output is collected in chunks of this size before being
+// handed to the sinks, so a long message costs a few sink calls rather
+// than one per character and is never truncated.
+#define LOG_CHUNK 128
+
+typedef struct {
+    char buf[LOG_CHUNK];
+    size_t len;
+    log_sink_t only; // Just this sink, or all registered ones if NULL.
+} log_buf_t;
+
+static void uart_sink(const char* buf, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        if (buf[i] == '\n')
+            mtk_uart_putc('\r');
+
+        mtk_uart_putc(buf[i]);
+    }
 }
 
 #ifdef CONFIG_LK_LOG_STORE
-void lk_log_store(int c, void* ctx) {
-    (void)ctx;
-    ((void (*)(int))(CONFIG_LK_LOG_STORE_ADDRESS | 1))(c);
+static void lk_log_store_sink(const char* buf, size_t len) {
+    for (size_t i = 0; i < len; i++)
+        ((void (*)(int))(CONFIG_LK_LOG_STORE_ADDRESS | 1))(buf[i]);
 }
 #endif
 
-int printf(const char* fmt, ...) {
-    va_list args;
-    va_start(args, fmt);
-
-    int ret = npf_vpprintf(&uart_putc, NULL, fmt, args);
-
+// printf() may run before anything has had a chance to register, so
+// the built-in sinks are there from the start.
+static log_sink_t sinks[LOG_SINK_MAX] = {
+    uart_sink,
 #ifdef CONFIG_LK_LOG_STORE
-    va_start(args, fmt);
-    npf_vpprintf(&lk_log_store, NULL, fmt, args);
+    lk_log_store_sink,
 #endif
+};
+
+int log_sink_register(log_sink_t sink) {
+    for (size_t i = 0; i < LOG_SINK_MAX; i++) {
+        if (sinks[i] == sink)
+            return 0;
+    }
 
+    for (size_t i = 0; i < LOG_SINK_MAX; i++) {
+        if (!sinks[i]) {
+            sinks[i] = sink;
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+void log_sink_unregister(log_sink_t sink) {
+    for (size_t i = 0; i < LOG_SINK_MAX; i++) {
+        if (sinks[i] == sink)
+            sinks[i] = NULL;
+    }
+}
+
+static void log_flush(log_buf_t* b) {
+    if (!b->len) return;
+
+    if (b->only) {
+        b->only(b->buf, b->len);
+    } else {
+        for (size_t i = 0; i < LOG_SINK_MAX; i++) {
+            if (sinks[i])
+                sinks[i](b->buf, b->len);
+        }
+    }
+
+    b->len = 0;
+}
+
+static void log_putc(int c, void* ctx) {
+    log_buf_t* b = ctx;
+
+    b->buf[b->len++] = c;
+    if (b->len == sizeof(b->buf))
+        log_flush(b);
+}
+
+// Runs the formatter once and fans the result out, instead of
+// formatting the same message again for every destination.
+static int log_vprintf(log_sink_t only, const char* fmt, va_list args) {
+    log_buf_t b;
+
+    b.len = 0;
+    b.only = only;
+
+    int ret = npf_vpprintf(&log_putc, &b, fmt, args);
+    log_flush(&b);
+    return ret;
+}
+
+int printf(const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    int ret = log_vprintf(NULL, fmt, args);
     va_end(args);
     return ret;
 }
@@ -51,20 +123,22 @@ int video_printf(const char* fmt, ...) {
 }
 
 #ifdef CONFIG_FRAMEBUFFER_SUPPORT
-void fb_putc_callback(int c, void *ctx) {
-    (void)ctx;
-    fb_putc(c);
+// Not registered by default. Boards that want everything printf()
+// says on screen too can add it with log_sink_register().
+void fb_log_sink(const char* buf, size_t len) {
+    for (size_t i = 0; i < len; i++)
+        fb_putc(buf[i]);
+
+    fb_update_display();
 }
 
-int fb_vprintf(const char *fmt, va_list args) {
-    return npf_vpprintf(&fb_putc_callback, NULL, fmt, args);
+static void fb_text_sink(const char* buf, size_t len) {
+    for (size_t i = 0; i < len; i++)
+        fb_putc(buf[i]);
 }
 
-void fb_update_display(void) {
-    fb_config_t *config = fb_get_config();
-    if (!config->buffer) return;
-    uint32_t fb_size = config->width * config->height * config->bppx;
-    arch_clean_invalidate_cache_range((uintptr_t)config->buffer, fb_size);
+int fb_vprintf(const char *fmt, va_list args) {
+    return log_vprintf(fb_text_sink, fmt, args);
 }
 
 int fb_printf(const char *fmt, ...) {
@@ -77,30 +151,109 @@ int fb_printf(const char *fmt, ...) {
 }
 #endif
 
-void hexdump(const void* data, size_t size, int (*out)(const char *, ...)) {
-    const uint8_t* ptr = (const uint8_t*)data;
+static const char hex_digits[16] = "0123456789abcdef";
 
-    for (size_t i = 0; i < size; i += 16) {
-        out("%08x: ", (uintptr_t)(ptr + i));
+static char* hex_put(char* p, uint32_t value, int digits) {
+    while (digits--)
+        *p++ = hex_digits[(value >> (digits * 4)) & 0xF];
+    return p;
+}
 
-        for (size_t j = 0; j < 16; j++) {
-            if (i + j < size)
-                out("%02x ", ptr[i + j]);
-            else
-                out("   ");
-            if (j == 7)
-                out(" ");
-        }
+// Renders one line of up to HEXDUMP_LINE bytes. The line is handed to
+// out() as the format string itself, since video_printf() passes
+// nothing but that on to LK, so any '%' in the text column is doubled.
+static void hexdump_line(uint64_t addr, const uint8_t* ptr, size_t n,
+                         int (*out)(const char *, ...)) {
+    // Address, hex and text columns, with every character a '%'.
+    char line[18 + HEXDUMP_LINE * 3 + 1 + 2 + HEXDUMP_LINE * 2 + 3];
+    char* p = line;
+
+    if (addr >> 32)
+        p = hex_put(p, addr >> 32, 8);
+    p = hex_put(p, addr, 8);
+    *p++ = ':';
+    *p++ = ' ';
 
-        out(" |");
-        for (size_t j = 0; j < 16; j++) {
-            if (i + j < size) {
-                uint8_t c = ptr[i + j];
-                out("%c", (c >= 32 && c < 127) ? c : '.');
-            }
+    for (size_t j = 0; j < HEXDUMP_LINE; j++) {
+        if (j < n) {
+            p = hex_put(p, ptr[j], 2);
+            *p++ = ' ';
+        } else {
+            *p++ = ' ';
+            *p++ = ' ';
+            *p++ = ' ';
         }
-        out("|\n");
+        if (j == 7)
+            *p++ = ' ';
+    }
+
+    *p++ = ' ';
+    *p++ = '|';
+    for (size_t j = 0; j < n; j++) {
+        uint8_t c = ptr[j];
+        *p++ = (c >= 32 && c < 127) ? c : '.';
+        if (c == '%')
+            *p++ = '%';
+    }
+    *p++ = '|';
+    *p++ = '\n';
+    *p = '\0';
+
+    out(line);
+}
+
+void hexdump_begin(hexdump_stream_t* s, uint64_t addr, int (*out)(const char *, ...)) {
+    s->out = out;
+    s->addr = addr;
+    s->len = 0;
+}
+
+// Whole lines are dumped straight from data, only a partial one at
+// either end goes through the stream's own buffer.
+void hexdump_write(hexdump_stream_t* s, const void* data, size_t size) {
+    const uint8_t* ptr = (const uint8_t*)data;
+
+    if (s->len) {
+        size_t n = HEXDUMP_LINE - s->len;
+        if (n > size)
+            n = size;
+
+        memcpy(s->buf + s->len, ptr, n);
+        s->len += n;
+        ptr += n;
+        size -= n;
+
+        if (s->len < HEXDUMP_LINE)
+            return;
+
+        hexdump_line(s->addr, s->buf, HEXDUMP_LINE, s->out);
+        s->addr += HEXDUMP_LINE;
+        s->len = 0;
+    }
+
+    for (; size >= HEXDUMP_LINE; size -= HEXDUMP_LINE, ptr += HEXDUMP_LINE) {
+        hexdump_line(s->addr, ptr, HEXDUMP_LINE, s->out);
+        s->addr += HEXDUMP_LINE;
     }
+
+    memcpy(s->buf, ptr, size);
+    s->len = size;
+}
+
+void hexdump_end(hexdump_stream_t* s) {
+    if (s->len)
+        hexdump_line(s->addr, s->buf, s->len, s->out);
+
+    s->addr += s->len;
+    s->len = 0;
+}
+
+void hexdump(const void* data, size_t size, int (*out)(const char *, ...)) {
+    hexdump_stream_t s;
+
+    hexdump_begin(&s, (uintptr_t)data, out);
+    hexdump_write(&s, data, size);
+    hexdump_end(&s);
 }
 
 void uart_hexdump(const void* data, size_t size) {
@@ -66,4 +66,34 @@ void fastboot_publish(const char* name, const char* value) {
 
 #else
 #error "No fastboot response style selected."
-#endif
\ No newline at end of file
+#endif
+
+// For sending binary data back to the host, since LK's upload path
+// isn't something we can reach. Anything over FASTBOOT_BASE64_MAX
+// bytes is cut short.
+void fastboot_info_base64(const void* data, unsigned len) {
+    static const char b64[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    const unsigned char* p = data;
+    char text[FASTBOOT_BASE64_MAX / 3 * 4 + 1];
+    char* t = text;
+
+    if (len > FASTBOOT_BASE64_MAX)
+        len = FASTBOOT_BASE64_MAX;
+
+    for (unsigned i = 0; i < len; i += 3) {
+        unsigned left = len - i;
+        unsigned v = p[i] << 16;
+
+        if (left > 1) v |= p[i + 1] << 8;
+        if (left > 2) v |= p[i + 2];
+
+        *t++ = b64[v >> 18];
+        *t++ = b64[(v >> 12) & 0x3F];
+        *t++ = left > 1 ? b64[(v >> 6) & 0x3F] : '=';
+        *t++ = left > 2 ? b64[v & 0x3F] : '=';
+    }
+    *t = '\0';
+
+    fastboot_info(text);
+}
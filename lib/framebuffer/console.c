@@ -0,0 +1,134 @@
+//
+// SPDX-FileCopyrightText: 2026 Roger Ortiz <roger@r0rt1z2.com>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+
+#include <lib/debug.h>
+#include <lib/fastboot.h>
+#include <lib/framebuffer.h>
+#include <lib/string.h>
+
+// Enough columns for the smallest text scale, whichever way the
+// panel is rotated.
+#define CONSOLE_COLS ((CONFIG_FRAMEBUFFER_WIDTH > CONFIG_FRAMEBUFFER_HEIGHT ? \
+                       CONFIG_FRAMEBUFFER_WIDTH : CONFIG_FRAMEBUFFER_HEIGHT) / 8)
+#define CONSOLE_LINES CONFIG_FRAMEBUFFER_CONSOLE_LINES
+
+// Scrollback, as text rather than pixels. Lines keep a single colour,
+// the one that was active when their last character was printed.
+static char text[CONSOLE_LINES][CONSOLE_COLS];
+static uint32_t colors[CONSOLE_LINES];
+static uint32_t head = 0;  // Line being written to.
+static uint32_t lines = 1; // Lines in the ring, including head.
+static uint32_t col = 0;
+static uint32_t view = 0;  // How many lines back we're looking.
+
+static uint32_t line_height(void) {
+    return fb_get_char_height() + FB_LINE_SPACING;
+}
+
+static uint32_t visible_lines(void) {
+    fb_config_t *fb = fb_get_config();
+    return (fb->height - fb_get_char_height()) / line_height() + 1;
+}
+
+// Repaints the screen from the ring, ending view lines before the
+// newest one. Only used when moving through the scrollback, normal
+// output just draws the new characters and scrolls.
+static void console_redraw(void) {
+    fb_config_t *fb = fb_get_config();
+    uint32_t rows = visible_lines();
+    uint32_t shown = lines - view;
+    uint32_t cols = fb->width / fb_get_char_width();
+
+    if (shown > rows)
+        shown = rows;
+
+    if (cols > CONSOLE_COLS)
+        cols = CONSOLE_COLS;
+
+    fb_fill_rect(0, 0, fb->width, fb->height, FB_BLACK);
+
+    for (uint32_t i = 0; i < shown; i++) {
+        uint32_t back = view + shown - 1 - i;
+        uint32_t line = (head + CONSOLE_LINES - back) % CONSOLE_LINES;
+
+        for (uint32_t c = 0; c < cols && text[line][c]; c++)
+            fb_char(c * fb_get_char_width(), i * line_height(), text[line][c], colors[line]);
+    }
+
+    fb_set_cursor(col * fb_get_char_width(), (shown - 1) * line_height());
+}
+
+// Moves the view lines back (positive) or forward (negative) through
+// the scrollback. Any new output jumps back to the bottom.
+void fb_console_scroll(int delta) {
+    int max = lines > visible_lines() ? (int)(lines - visible_lines()) : 0;
+    int target = (int)view + delta;
+
+    if (target < 0) target = 0;
+    if (target > max) target = max;
+
+    if ((uint32_t)target == view)
+        return;
+
+    view = target;
+    console_redraw();
+    fb_update_display();
+}
+
+void fb_console_putc(char c) {
+    if (view) {
+        view = 0;
+        console_redraw();
+    }
+
+    if (c == '\r') {
+        col = 0;
+    } else if (c >= 32 && col < CONSOLE_COLS) {
+        text[head][col++] = c;
+        colors[head] = fb_get_text_color();
+    }
+}
+
+// Called by fb_cursor_newline(), both for '\n' and when a line wraps.
+void fb_console_newline(void) {
+    head = (head + 1) % CONSOLE_LINES;
+    memset(text[head], 0, CONSOLE_COLS);
+    col = 0;
+
+    if (lines < CONSOLE_LINES)
+        lines++;
+}
+
+// 'fastboot oem scroll <lines>' pages back (positive) or forward
+// (negative) through the scrollback, since most boards have no keys
+// to spare for it. Without an argument it returns to the newest line.
+static void cmd_scroll(const char *arg, void *data, unsigned sz) {
+    char buffer[32];
+    char *end = NULL;
+    long delta = -(long)view;
+
+    (void)data;
+    (void)sz;
+
+    while (*arg == ' ') arg++;
+
+    if (*arg) {
+        delta = strtol(arg, &end, 10);
+        if (end == arg || *end) {
+            fastboot_fail("Usage: fastboot oem scroll [lines]");
+            return;
+        }
+    }
+
+    fb_console_scroll(delta);
+
+    npf_snprintf(buffer, sizeof(buffer), "%u of %u lines back", view, lines - 1);
+    fastboot_info(buffer);
+    fastboot_okay("");
+}
+
+void fb_console_init(void) {
+    fastboot_register("oem scroll", cmd_scroll, 1);
+}
@@ -140,31 +140,11 @@ static const uint8_t font8x8_data[128][8] = {
     { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}    // U+007F
 };
 
-void fb_char(uint32_t x, uint32_t y, char c, uint32_t color) {
-    if (c < 0 || c >= 128) return;
-    
-    uint32_t scale = fb_get_text_scale();
-    
-    for (int row = 0; row < 8; row++) {
-        uint8_t line = font8x8_data[(unsigned char)c][row];
-        for (int col = 0; col < 8; col++) {
-            if (line & (1 << col)) {
-                for (uint32_t sy = 0; sy < scale; sy++) {
-                    for (uint32_t sx = 0; sx < scale; sx++) {
-                        fb_pixel(x + (col * scale) + sx, y + (row * scale) + sy, color);
-                    }
-                }
-            }
-        }
-    }
-}
-
-uint32_t fb_get_char_width(void) {
-    return 8 * fb_get_text_scale();
-}
-
-uint32_t fb_get_char_height(void) {
-    return 8 * fb_get_text_scale();
-}
+const fb_font_t fb_font = {
+    .glyphs = font8x8_data,
+    .first = 0,
+    .count = 128,
+    .msb_first = false,
+};
 
 #endif
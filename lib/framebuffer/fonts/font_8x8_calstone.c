@@ -109,27 +109,11 @@ static const uint8_t font8x8_calstone_data[96][8] = {
     { 0x3c, 0x66, 0xdb, 0xb1, 0xb1, 0xdb, 0x66, 0x3c }   // ©
 };
 
-void fb_char(uint32_t x, uint32_t y, char c, uint32_t color) {
-    int index = c - 32;
-    if (index < 0 || index >= 96) return;
-    
-    uint32_t scale = fb_get_text_scale();
-    
-    for (int row = 0; row < 8; row++) {
-        uint8_t line = font8x8_calstone_data[index][row];
-        for (int col = 0; col < 8; col++) {
-            if (line & (1 << (7 - col))) {
-                fb_fill_rect(x + (col * scale), y + (row * scale), scale, scale, color);
-            }
-        }
-    }
-}
-uint32_t fb_get_char_width(void) {
-    return 8 * fb_get_text_scale();
-}
-
-uint32_t fb_get_char_height(void) {
-    return 8 * fb_get_text_scale();
-}
+const fb_font_t fb_font = {
+    .glyphs = font8x8_calstone_data,
+    .first = 32,
+    .count = 96,
+    .msb_first = true,
+};
 
 #endif
\ No newline at end of file
@@ -109,33 +109,11 @@ static const uint8_t font8x8_comic_fans_data[96][8] = {
     { 0x1c, 0x22, 0x49, 0x95, 0xa1, 0x99, 0x42, 0x3c }   // ©
 };
 
-void fb_char(uint32_t x, uint32_t y, char c, uint32_t color) {
-    int index = c - 32;
-    
-    if (index < 0 || index >= 96) return;
-    
-    uint32_t scale = fb_get_text_scale();
-    
-    for (int row = 0; row < 8; row++) {
-        uint8_t line = font8x8_comic_fans_data[index][row];
-        for (int col = 0; col < 8; col++) {
-            if (line & (1 << (7 - col))) {
-                for (uint32_t sy = 0; sy < scale; sy++) {
-                    for (uint32_t sx = 0; sx < scale; sx++) {
-                        fb_pixel(x + (col * scale) + sx, y + (row * scale) + sy, color);
-                    }
-                }
-            }
-        }
-    }
-}
-
-uint32_t fb_get_char_width(void) {
-    return 8 * fb_get_text_scale();
-}
-
-uint32_t fb_get_char_height(void) {
-    return 8 * fb_get_text_scale();
-}
+const fb_font_t fb_font = {
+    .glyphs = font8x8_comic_fans_data,
+    .first = 32,
+    .count = 96,
+    .msb_first = true,
+};
 
 #endif
\ No newline at end of file
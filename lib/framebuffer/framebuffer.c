@@ -3,7 +3,127 @@
 // SPDX-License-Identifier: AGPL-3.0-or-later
 //
 
+#include <lib/debug.h>
 #include <lib/framebuffer.h>
+#include <lib/string.h>
+
+#ifdef CONFIG_FRAMEBUFFER_BACK_BUFFER
+#include <lib/heap.h>
+#endif
+
+// Pixel format kernels, picked at build time so draw loops never
+// branch on the format. Colours are always passed around as ARGB8888
+// and converted once per draw call with fb_encode().
+#if defined(CONFIG_FRAMEBUFFER_FORMAT_RGB565)
+#define FB_PIXEL_BYTES 2
+
+static inline uint32_t fb_encode(uint32_t c) {
+    return ((c >> 8) & 0xF800) | ((c >> 5) & 0x07E0) | ((c >> 3) & 0x001F);
+}
+
+static inline void fb_store(uint8_t *p, uint32_t px) {
+    *(uint16_t *)p = px;
+}
+
+// Two pixels per word once dst is word aligned, four words at a time.
+static void fb_span(uint8_t *dst, uint32_t count, uint32_t px) {
+    uint16_t *d16 = (uint16_t *)dst;
+
+    if (((uintptr_t)d16 & 2) && count) {
+        *d16++ = px;
+        count--;
+    }
+
+    uint32_t pair = px | (px << 16);
+    uint32_t *d = (uint32_t *)d16;
+
+    for (; count >= 8; count -= 8, d += 4) {
+        d[0] = pair;
+        d[1] = pair;
+        d[2] = pair;
+        d[3] = pair;
+    }
+
+    for (; count >= 2; count -= 2)
+        *d++ = pair;
+
+    if (count)
+        *(uint16_t *)d = px;
+}
+#elif defined(CONFIG_FRAMEBUFFER_FORMAT_RGB888)
+#define FB_PIXEL_BYTES 3
+
+static inline uint32_t fb_encode(uint32_t c) {
+    return c & 0xFFFFFF;
+}
+
+static inline void fb_store(uint8_t *p, uint32_t px) {
+    p[0] = px;
+    p[1] = px >> 8;
+    p[2] = px >> 16;
+}
+
+// Four pixels are exactly three words, so once dst is word aligned
+// the span is written as a repeating three word pattern.
+static void fb_span(uint8_t *dst, uint32_t count, uint32_t px) {
+    for (; ((uintptr_t)dst & 3) && count; count--, dst += 3)
+        fb_store(dst, px);
+
+    uint32_t w0 = px | (px << 24);
+    uint32_t w1 = (px >> 8) | (px << 16);
+    uint32_t w2 = (px >> 16) | (px << 8);
+    uint32_t *d = (uint32_t *)dst;
+
+    for (; count >= 4; count -= 4, d += 3) {
+        d[0] = w0;
+        d[1] = w1;
+        d[2] = w2;
+    }
+
+    for (dst = (uint8_t *)d; count; count--, dst += 3)
+        fb_store(dst, px);
+}
+#else
+#define FB_PIXEL_BYTES 4
+
+#if defined(CONFIG_FRAMEBUFFER_FORMAT_ABGR8888)
+static inline uint32_t fb_encode(uint32_t c) {
+    return (c & 0xFF00FF00) | ((c >> 16) & 0xFF) | ((c & 0xFF) << 16);
+}
+#else
+static inline uint32_t fb_encode(uint32_t c) {
+    return c;
+}
+#endif
+
+static inline void fb_store(uint8_t *p, uint32_t px) {
+    *(uint32_t *)p = px;
+}
+
+// Once dst is 8 byte aligned, pixels are stored in pairs, which the
+// compiler turns into STRD, four at a time.
+static void fb_span(uint8_t *dst, uint32_t count, uint32_t px) {
+    uint32_t *d32 = (uint32_t *)dst;
+
+    if (((uintptr_t)d32 & 4) && count) {
+        *d32++ = px;
+        count--;
+    }
+
+    uint64_t pair = ((uint64_t)px << 32) | px;
+    uint64_t *d = (uint64_t *)d32;
+
+    for (; count >= 8; count -= 8, d += 4) {
+        d[0] = pair;
+        d[1] = pair;
+        d[2] = pair;
+        d[3] = pair;
+    }
+
+    for (d32 = (uint32_t *)d; count; count--)
+        *d32++ = px;
+}
+#endif
 
 static fb_config_t fb_config = {0};
 
@@ -12,17 +132,65 @@ static uint32_t cursor_x = 0;
 static uint32_t cursor_y = 0;
 static uint32_t text_color = FB_WHITE;
 
-void fb_init(uint32_t *fb_addr, uint32_t width, uint32_t height, uint32_t bppx, uint32_t alignment) {
+#define GLYPH_SIZE 8
+#define GLYPH_MAX 128
+#define GLYPH_RUNS 4 // An 8 pixel row has at most 4 runs of set bits.
+
+// A glyph expanded at the current text scale into horizontal runs,
+// so drawing it is a handful of span fills per row instead of a test
+// per bit and a store per pixel. Runs are laid out in the panel's own
+// orientation, so a rotated glyph is still drawn as one block of whole
+// rows. They don't depend on the colour, so only a scale or rotation
+// change invalidates them.
+typedef struct {
+    uint8_t count[GLYPH_SIZE];
+    uint8_t start[GLYPH_SIZE][GLYPH_RUNS];
+    uint8_t len[GLYPH_SIZE][GLYPH_RUNS];
+} fb_glyph_t;
+
+static fb_glyph_t glyph_cache[GLYPH_MAX];
+static uint32_t glyph_valid[GLYPH_MAX / 32];
+
+static fb_rect_t dirty[CONFIG_FRAMEBUFFER_DIRTY_RECTS];
+static uint32_t dirty_count = 0;
+static uint32_t dirty_last = 0;
+static fb_update_hook_t update_hook = NULL;
+
+void fb_init(void *fb_addr, uint32_t width, uint32_t height, uint32_t bppx, uint32_t alignment) {
     fb_config.buffer = fb_addr;
-    fb_config.width = width;
-    fb_config.height = height;
+    fb_config.scanout = fb_addr;
+    fb_config.phys_width = width;
+    fb_config.phys_height = height;
     fb_config.bppx = bppx;
     fb_config.stride = ((width * bppx + alignment - 1) & ~(alignment - 1));
     
+    fb_set_rotation(CONFIG_FRAMEBUFFER_ROTATION);
+    fb_set_text_scale(1);
+    text_color = FB_WHITE;
+    dirty_count = 0;
+}
+
+// Boards with a panel mounted the other way around call this after
+// framebuffer_init() to override the Kconfig default. Everything drawn
+// afterwards is in the new orientation; what is already on screen
+// stays where it is.
+void fb_set_rotation(uint32_t degrees) {
+    if (degrees != 0 && degrees != 90 && degrees != 180 && degrees != 270)
+        return;
+
+    bool sideways = degrees == 90 || degrees == 270;
+
+    fb_config.rotation = degrees;
+    fb_config.width = sideways ? fb_config.phys_height : fb_config.phys_width;
+    fb_config.height = sideways ? fb_config.phys_width : fb_config.phys_height;
+
+    memset(glyph_valid, 0, sizeof(glyph_valid));
     cursor_x = 0;
     cursor_y = 0;
-    text_scale = 1;
-    text_color = FB_WHITE;
+}
+
+uint32_t fb_get_rotation(void) {
+    return fb_config.rotation;
 }
 
 fb_config_t *fb_get_config(void) {
@@ -33,68 +201,273 @@ bool fb_valid(uint32_t x, uint32_t y) {
     return (x < fb_config.width && y < fb_config.height);
 }
 
+static inline uint8_t *fb_row(uint32_t y) {
+    return (uint8_t *)fb_config.buffer + y * fb_config.stride;
+}
+
+static inline uint8_t *fb_addr(uint32_t x, uint32_t y) {
+    return fb_row(y) + x * FB_PIXEL_BYTES;
+}
+
+// Maps a rectangle from drawing coordinates to the panel's own, with
+// rotation being clockwise. A rectangle stays a rectangle under any
+// multiple of 90 degrees, so this is done once per draw call instead
+// of once per pixel. Takes unclipped values, negative ones included,
+// and leaves it to fb_clip() to cut off whatever ends up off screen.
+static void fb_rotate(uint32_t *x, uint32_t *y, uint32_t *w, uint32_t *h) {
+    uint32_t t;
+
+    switch (fb_config.rotation) {
+    case 90:
+        t = *x;
+        *x = fb_config.phys_width - *y - *h;
+        *y = t;
+        break;
+    case 180:
+        *x = fb_config.phys_width - *x - *w;
+        *y = fb_config.phys_height - *y - *h;
+        return;
+    case 270:
+        t = *y;
+        *y = fb_config.phys_height - *x - *w;
+        *x = t;
+        break;
+    default:
+        return;
+    }
+
+    t = *w;
+    *w = *h;
+    *h = t;
+}
+
+// Clips a rectangle against the panel once, so the fill loops below
+// don't have to check every pixel. Returns false if nothing is left.
+static bool fb_clip(uint32_t *x, uint32_t *y, uint32_t *w, uint32_t *h) {
+    if (!fb_config.buffer) return false;
+
+    // Callers compute coordinates in unsigned math, so something that
+    // starts left of or above the screen shows up as a huge value.
+    if ((int32_t)*x < 0) {
+        if (*w <= -*x) return false;
+        *w += *x;
+        *x = 0;
+    }
+
+    if ((int32_t)*y < 0) {
+        if (*h <= -*y) return false;
+        *h += *y;
+        *y = 0;
+    }
+
+    if (*x >= fb_config.phys_width || *y >= fb_config.phys_height)
+        return false;
+
+    if (*w > fb_config.phys_width - *x) *w = fb_config.phys_width - *x;
+    if (*h > fb_config.phys_height - *y) *h = fb_config.phys_height - *y;
+
+    return *w && *h;
+}
+
+static inline bool rect_touches(const fb_rect_t *r, uint32_t x, uint32_t y,
+                                uint32_t w, uint32_t h) {
+    return x <= r->x + r->w && r->x <= x + w && y <= r->y + r->h && r->y <= y + h;
+}
+
+static void rect_union(fb_rect_t *r, uint32_t x, uint32_t y, uint32_t w, uint32_t h) {
+    uint32_t x2 = r->x + r->w > x + w ? r->x + r->w : x + w;
+    uint32_t y2 = r->y + r->h > y + h ? r->y + r->h : y + h;
+
+    r->x = r->x < x ? r->x : x;
+    r->y = r->y < y ? r->y : y;
+    r->w = x2 - r->x;
+    r->h = y2 - r->y;
+}
+
+// Adds an already clipped rectangle to the dirty list. Anything that
+// touches an existing entry is merged into it, and once the list is
+// full everything collapses into one bounding box, so an update never
+// costs more than a full-screen one.
+static void fb_dirty(uint32_t x, uint32_t y, uint32_t w, uint32_t h) {
+    // Shapes and glyphs that are partly off screen are marked a span at
+    // a time, and most of those spans land inside the rectangle that
+    // was just grown.
+    if (dirty_last < dirty_count) {
+        fb_rect_t *r = &dirty[dirty_last];
+        if (x >= r->x && y >= r->y && x + w <= r->x + r->w && y + h <= r->y + r->h)
+            return;
+    }
+
+    for (uint32_t i = 0; i < dirty_count; i++) {
+        if (rect_touches(&dirty[i], x, y, w, h)) {
+            rect_union(&dirty[i], x, y, w, h);
+            dirty_last = i;
+            return;
+        }
+    }
+
+    if (dirty_count == CONFIG_FRAMEBUFFER_DIRTY_RECTS) {
+        for (uint32_t i = 1; i < dirty_count; i++)
+            rect_union(&dirty[0], dirty[i].x, dirty[i].y, dirty[i].w, dirty[i].h);
+        rect_union(&dirty[0], x, y, w, h);
+        dirty_count = 1;
+        dirty_last = 0;
+        return;
+    }
+
+    dirty[dirty_count] = (fb_rect_t){x, y, w, h};
+    dirty_last = dirty_count++;
+}
+
+// Fills a rectangle given in panel coordinates. Everything ends up
+// here, so a horizontal line on a panel mounted sideways becomes a
+// single column in memory, and a filled rectangle is still written a
+// whole row at a time whatever the rotation.
+static void fb_fill_phys(uint32_t x, uint32_t y, uint32_t w, uint32_t h, uint32_t px) {
+    if (!fb_clip(&x, &y, &w, &h)) return;
+
+    fb_dirty(x, y, w, h);
+
+    uint8_t *p = fb_addr(x, y);
+
+    if (w == 1) {
+        for (; h; h--, p += fb_config.stride)
+            fb_store(p, px);
+        return;
+    }
+
+    for (; h; h--, p += fb_config.stride)
+        fb_span(p, w, px);
+}
+
+static inline void fb_fill(uint32_t x, uint32_t y, uint32_t w, uint32_t h, uint32_t px) {
+    fb_rotate(&x, &y, &w, &h);
+    fb_fill_phys(x, y, w, h, px);
+}
+
 void fb_pixel(uint32_t x, uint32_t y, uint32_t color) {
-    if (!fb_valid(x, y) || !fb_config.buffer) return;
-    
-    uint32_t offset = (y * fb_config.stride / sizeof(uint32_t)) + x;
-    fb_config.buffer[offset] = color;
+    if (!fb_valid(x, y)) return;
+
+    fb_fill(x, y, 1, 1, fb_encode(color));
+}
+
+void fb_hline(uint32_t x, uint32_t y, uint32_t w, uint32_t color) {
+    fb_fill(x, y, w, 1, fb_encode(color));
+}
+
+void fb_vline(uint32_t x, uint32_t y, uint32_t h, uint32_t color) {
+    fb_fill(x, y, 1, h, fb_encode(color));
 }
 
 void fb_clear(uint32_t color) {
     if (!fb_config.buffer) return;
-    
-    for (uint32_t y = 0; y < fb_config.height; y++) {
-        for (uint32_t x = 0; x < fb_config.width; x++) {
-            fb_pixel(x, y, color);
-        }
+
+    // Rows are contiguous unless the stride has padding, in which
+    // case the padding is left alone.
+    uint32_t px = fb_encode(color);
+
+    if (fb_config.stride == fb_config.phys_width * FB_PIXEL_BYTES) {
+        fb_span(fb_row(0), fb_config.phys_width * fb_config.phys_height, px);
+    } else {
+        for (uint32_t y = 0; y < fb_config.phys_height; y++)
+            fb_span(fb_row(y), fb_config.phys_width, px);
     }
+
+    dirty[0] = (fb_rect_t){0, 0, fb_config.phys_width, fb_config.phys_height};
+    dirty_count = 1;
+    dirty_last = 0;
     
     cursor_x = 0;
     cursor_y = 0;
 }
 
 void fb_rect(uint32_t x, uint32_t y, uint32_t w, uint32_t h, uint32_t color) {
-    for (uint32_t i = 0; i < w; i++) {
-        fb_pixel(x + i, y, color);
-        fb_pixel(x + i, y + h - 1, color);
-    }
-    
-    for (uint32_t i = 0; i < h; i++) {
-        fb_pixel(x, y + i, color);
-        fb_pixel(x + w - 1, y + i, color);
-    }
+    if (!w || !h) return;
+
+    fb_hline(x, y, w, color);
+    fb_hline(x, y + h - 1, w, color);
+    fb_vline(x, y, h, color);
+    fb_vline(x + w - 1, y, h, color);
 }
 
 void fb_fill_rect(uint32_t x, uint32_t y, uint32_t w, uint32_t h, uint32_t color) {
-    for (uint32_t row = 0; row < h; row++) {
-        for (uint32_t col = 0; col < w; col++) {
-            fb_pixel(x + col, y + row, color);
-        }
-    }
+    fb_fill(x, y, w, h, fb_encode(color));
+}
+
+// Half-width of a circle of radius r, d rows away from its centre:
+// the largest x with x^2 + d^2 <= r^2. Callers walk d upwards and feed
+// back the previous result, so hw only ever steps down and a whole
+// circle costs O(r) instead of a test per pixel of its bounding box.
+static inline int32_t circle_hw(int32_t hw, int32_t d, int32_t r) {
+    while (hw > 0 && hw * hw + d * d > r * r)
+        hw--;
+    return hw;
+}
+
+static inline uint32_t rounded_radius(uint32_t w, uint32_t h, uint32_t radius) {
+    uint32_t max = (w < h ? w : h) / 2;
+    return radius > max ? max : radius;
 }
 
-void fb_rounded_rect(uint32_t x, uint32_t y, uint32_t w, uint32_t h, 
+// Corners are quarter circles of radius - 1, so the corner covers
+// exactly radius rows and columns.
+void fb_rounded_rect(uint32_t x, uint32_t y, uint32_t w, uint32_t h,
                     uint32_t radius, uint32_t color) {
-    for (uint32_t row = 0; row < h; row++) {
-        for (uint32_t col = 0; col < w; col++) {
-            bool skip_corner = false;
-            
-            if ((row < radius && col < radius) ||
-                (row < radius && col >= w - radius) ||
-                (row >= h - radius && col < radius) ||
-                (row >= h - radius && col >= w - radius)) {
-                
-                if ((row < radius - 1 && (col < radius - 1 || col >= w - radius + 1)) ||
-                    (row >= h - radius + 1 && (col < radius - 1 || col >= w - radius + 1))) {
-                    skip_corner = true;
-                }
-            }
-            
-            if (!skip_corner) {
-                fb_pixel(x + col, y + row, color);
-            }
+    radius = rounded_radius(w, h, radius);
+    if (!radius) {
+        fb_rect(x, y, w, h, color);
+        return;
+    }
+
+    int32_t rr = radius - 1;
+    int32_t left = x + rr, right = x + w - 1 - rr;
+    int32_t hw = rr;
+
+    for (int32_t d = 0; d <= rr; d++) {
+        hw = circle_hw(hw, d, rr);
+        int32_t next = d < rr ? circle_hw(hw, d + 1, rr) : -1;
+        uint32_t top = y + rr - d, bottom = y + h - 1 - rr + d;
+
+        if (d == rr) {
+            fb_hline(left - hw, top, right - left + 2 * hw + 1, color);
+            fb_hline(left - hw, bottom, right - left + 2 * hw + 1, color);
+            break;
         }
+
+        uint32_t run = hw > next ? hw - next : 1;
+        fb_hline(left - hw, top, run, color);
+        fb_hline(right + hw - run + 1, top, run, color);
+        fb_hline(left - hw, bottom, run, color);
+        fb_hline(right + hw - run + 1, bottom, run, color);
+    }
+
+    if (h > 2 * radius) {
+        fb_vline(x, y + radius, h - 2 * radius, color);
+        fb_vline(x + w - 1, y + radius, h - 2 * radius, color);
+    }
+}
+
+void fb_fill_rounded_rect(uint32_t x, uint32_t y, uint32_t w, uint32_t h,
+                          uint32_t radius, uint32_t color) {
+    radius = rounded_radius(w, h, radius);
+    if (!radius) {
+        fb_fill_rect(x, y, w, h, color);
+        return;
+    }
+
+    int32_t rr = radius - 1;
+    int32_t hw = rr;
+
+    for (int32_t d = 0; d <= rr; d++) {
+        hw = circle_hw(hw, d, rr);
+        uint32_t inset = rr - hw;
+
+        fb_hline(x + inset, y + rr - d, w - 2 * inset, color);
+        fb_hline(x + inset, y + h - 1 - rr + d, w - 2 * inset, color);
     }
+
+    if (h > 2 * radius)
+        fb_fill_rect(x, y + radius, w, h - 2 * radius, color);
 }
 
 void fb_arrow_right(uint32_t x, uint32_t y, uint32_t size, uint32_t color) {
@@ -109,6 +482,103 @@ void fb_arrow_right(uint32_t x, uint32_t y, uint32_t size, uint32_t color) {
     }
 }
 
+// Whether the glyph covers a pixel, given in the panel's orientation
+// relative to the glyph's top left corner as the panel sees it.
+static bool fb_glyph_bit(const uint8_t *bits, uint32_t row, uint32_t col) {
+    uint32_t r = row, c = col;
+
+    switch (fb_config.rotation) {
+    case 90:
+        r = GLYPH_SIZE - 1 - col;
+        c = row;
+        break;
+    case 180:
+        r = GLYPH_SIZE - 1 - row;
+        c = GLYPH_SIZE - 1 - col;
+        break;
+    case 270:
+        r = col;
+        c = GLYPH_SIZE - 1 - row;
+        break;
+    }
+
+    return bits[r] & (fb_font.msb_first ? 0x80 >> c : 1 << c);
+}
+
+static const fb_glyph_t *fb_glyph(unsigned char c) {
+    if (c < fb_font.first || c - fb_font.first >= fb_font.count || c >= GLYPH_MAX)
+        return NULL;
+
+    fb_glyph_t *g = &glyph_cache[c];
+    if (glyph_valid[c / 32] & (1u << (c % 32)))
+        return g;
+
+    const uint8_t *bits = fb_font.glyphs[c - fb_font.first];
+
+    for (uint32_t row = 0; row < GLYPH_SIZE; row++) {
+        uint32_t n = 0, col = 0;
+
+        while (col < GLYPH_SIZE && n < GLYPH_RUNS) {
+            uint32_t first = col;
+            while (col < GLYPH_SIZE && fb_glyph_bit(bits, row, col))
+                col++;
+
+            if (col > first) {
+                g->start[row][n] = first * text_scale;
+                g->len[row][n] = (col - first) * text_scale;
+                n++;
+            }
+            col++;
+        }
+
+        g->count[row] = n;
+    }
+
+    glyph_valid[c / 32] |= 1u << (c % 32);
+    return g;
+}
+
+void fb_char(uint32_t x, uint32_t y, char c, uint32_t color) {
+    const fb_glyph_t *g = fb_glyph((unsigned char)c);
+    uint32_t size = GLYPH_SIZE * text_scale;
+
+    uint32_t px = fb_encode(color);
+
+    if (!g || !fb_config.buffer) return;
+
+    // The cached runs are already rotated, only the cell has to move.
+    uint32_t w = size, h = size;
+    fb_rotate(&x, &y, &w, &h);
+
+    // Glyphs that are fully on screen skip per-run clipping.
+    bool inside = x < fb_config.phys_width && y < fb_config.phys_height &&
+                  size <= fb_config.phys_width - x && size <= fb_config.phys_height - y;
+
+    for (uint32_t row = 0; row < GLYPH_SIZE; row++) {
+        for (uint32_t i = 0; i < g->count[row]; i++) {
+            for (uint32_t sy = 0; sy < text_scale; sy++) {
+                uint32_t py = y + row * text_scale + sy;
+
+                if (inside)
+                    fb_span(fb_addr(x + g->start[row][i], py), g->len[row][i], px);
+                else
+                    fb_fill_phys(x + g->start[row][i], py, g->len[row][i], 1, px);
+            }
+        }
+    }
+
+    if (inside)
+        fb_dirty(x, y, size, size);
+}
+
+uint32_t fb_get_char_width(void) {
+    return GLYPH_SIZE * text_scale;
+}
+
+uint32_t fb_get_char_height(void) {
+    return GLYPH_SIZE * text_scale;
+}
+
 void fb_text(uint32_t x, uint32_t y, const char *str, uint32_t color) {
     uint32_t pos_x = x;
     uint32_t char_width = fb_get_char_width();
@@ -120,6 +590,106 @@ void fb_text(uint32_t x, uint32_t y, const char *str, uint32_t color) {
     }
 }
 
+// Moves the whole screen up by dy rows and fills the rows exposed at
+// the bottom with color.
+void fb_scroll(uint32_t dy, uint32_t color) {
+    if (!fb_config.buffer || !dy) return;
+
+    if (dy >= fb_config.height)
+        dy = fb_config.height;
+
+    uint32_t keep = fb_config.height - dy;
+
+    switch (fb_config.rotation) {
+    case 0:
+        memmove(fb_row(0), fb_row(dy), keep * fb_config.stride);
+        break;
+    case 180:
+        memmove(fb_row(dy), fb_row(0), keep * fb_config.stride);
+        break;
+    // Up is sideways in the panel's rows, so each one moves on its own.
+    case 90:
+        for (uint32_t y = 0; keep && y < fb_config.phys_height; y++)
+            memmove(fb_addr(dy, y), fb_addr(0, y), keep * FB_PIXEL_BYTES);
+        break;
+    case 270:
+        for (uint32_t y = 0; keep && y < fb_config.phys_height; y++)
+            memmove(fb_addr(0, y), fb_addr(dy, y), keep * FB_PIXEL_BYTES);
+        break;
+    }
+
+    fb_fill_rect(0, keep, fb_config.width, dy, color);
+    fb_dirty(0, 0, fb_config.phys_width, fb_config.phys_height);
+}
+
+// For boards that let LK draw on the screen behind the library's back.
+// Takes drawing coordinates, like everything else. With a back buffer,
+// the area is first copied back from the screen so presenting it keeps
+// what LK drew, which also drops anything we drew there since the last
+// fb_update_display().
+void fb_mark_dirty(uint32_t x, uint32_t y, uint32_t w, uint32_t h) {
+    fb_rotate(&x, &y, &w, &h);
+    if (!fb_clip(&x, &y, &w, &h)) return;
+
+    if (fb_config.buffer != fb_config.scanout) {
+        uint32_t offset = y * fb_config.stride + x * FB_PIXEL_BYTES;
+
+        for (uint32_t row = 0; row < h; row++, offset += fb_config.stride)
+            memcpy((uint8_t *)fb_config.buffer + offset,
+                   (const uint8_t *)fb_config.scanout + offset, w * FB_PIXEL_BYTES);
+    }
+
+    fb_dirty(x, y, w, h);
+}
+
+// Called with every dirty rectangle once it has been flushed, i.e.
+// to push it to the panel on devices that need an explicit update.
+// Rectangles are in panel coordinates, regardless of rotation.
+void fb_set_update_hook(fb_update_hook_t hook) {
+    update_hook = hook;
+}
+
+// Copies a dirty rectangle from the back buffer to the scanout buffer,
+// if there is one, and flushes it out of the cache. Rows are copied
+// one by one so we never overwrite what LK drew around them.
+static void fb_present_rect(const fb_rect_t *r) {
+    uint32_t offset = r->y * fb_config.stride + r->x * FB_PIXEL_BYTES;
+    uintptr_t start = (uintptr_t)fb_config.scanout + offset;
+    uint32_t len = r->w * FB_PIXEL_BYTES;
+
+    if (fb_config.buffer != fb_config.scanout) {
+        const uint8_t *src = (const uint8_t *)fb_config.buffer + offset;
+
+        for (uint32_t row = 0; row < r->h; row++)
+            memcpy((void *)(start + row * fb_config.stride), src + row * fb_config.stride, len);
+    }
+
+    // Once a rectangle covers most of each row, one call over the
+    // whole block beats walking it row by row.
+    if (len * 2 >= fb_config.stride) {
+        arch_clean_invalidate_cache_range(start, (r->h - 1) * fb_config.stride + len);
+        return;
+    }
+
+    for (uint32_t row = 0; row < r->h; row++, start += fb_config.stride)
+        arch_clean_invalidate_cache_range(start, len);
+}
+
+// Presents whatever was drawn since the last update: copies it to the
+// scanout buffer when drawing into a back buffer, flushes only those
+// cache lines, then hands each dirty rectangle to the update hook.
+void fb_update_display(void) {
+    if (!fb_config.buffer) return;
+
+    for (uint32_t i = 0; i < dirty_count; i++) {
+        fb_present_rect(&dirty[i]);
+        if (update_hook)
+            update_hook(dirty[i].x, dirty[i].y, dirty[i].w, dirty[i].h);
+    }
+
+    dirty_count = 0;
+}
+
 uint32_t fb_rgb(uint8_t r, uint8_t g, uint8_t b) {
     return 0xFF000000 | (r << 16) | (g << 8) | b;
 }
@@ -143,8 +713,9 @@ uint32_t fb_get_text_color(void) {
 }
 
 void fb_set_text_scale(uint32_t scale) {
-    if (scale >= 1 && scale <= 8) {
+    if (scale >= 1 && scale <= 8 && scale != text_scale) {
         text_scale = scale;
+        memset(glyph_valid, 0, sizeof(glyph_valid));
     }
 }
 
@@ -161,12 +732,28 @@ void fb_cursor_advance(void) {
 }
 
 void fb_cursor_newline(void) {
+    uint32_t line_h = fb_get_char_height() + FB_LINE_SPACING;
+
     cursor_x = 0;
-    cursor_y += fb_get_char_height() + 4;
+
+#ifdef CONFIG_FRAMEBUFFER_CONSOLE
+    fb_console_newline();
+
+    // Scroll instead of wrapping around, so the newest line is always
+    // at the bottom and older ones stay readable above it.
+    if (cursor_y + line_h + fb_get_char_height() > fb_config.height) {
+        fb_scroll(line_h, FB_BLACK);
+        return;
+    }
+
+    cursor_y += line_h;
+#else
+    cursor_y += line_h;
     
     if (cursor_y + fb_get_char_height() > fb_config.height) {
         cursor_y = 0;
     }
+#endif
 }
 
 void fb_cursor_home(void) {
@@ -175,6 +762,10 @@ void fb_cursor_home(void) {
 }
 
 void fb_putc(char c) {
+#ifdef CONFIG_FRAMEBUFFER_CONSOLE
+    fb_console_putc(c);
+#endif
+
     if (c == '\n') {
         fb_cursor_newline();
     } else if (c == '\r') {
@@ -206,19 +797,130 @@ void fb_fill_triangle_rounded(uint32_t cx, uint32_t top_y, uint32_t size,
         if (half_w <= trim) continue;
         uint32_t draw_hw = half_w - trim;
 
-        for (uint32_t col = 0; col < draw_hw * 2 + 1; col++) {
-            fb_pixel(cx - draw_hw + col, top_y + row, color);
-        }
+        fb_hline(cx - draw_hw, top_y + row, draw_hw * 2 + 1, color);
     }
 }
 
 void fb_fill_circle(uint32_t cx, uint32_t cy, uint32_t r, uint32_t color) {
-    for (int dy = -(int)r; dy <= (int)r; dy++) {
-        for (int dx = -(int)r; dx <= (int)r; dx++) {
-            if (dx * dx + dy * dy <= (int)(r * r)) {
-                fb_pixel(cx + dx, cy + dy, color);
+    int32_t hw = r;
+
+    for (int32_t d = 0; d <= (int32_t)r; d++) {
+        hw = circle_hw(hw, d, r);
+
+        fb_hline(cx - hw, cy - d, 2 * hw + 1, color);
+        if (d)
+            fb_hline(cx - hw, cy + d, 2 * hw + 1, color);
+    }
+}
+
+// Each row gets the run between its half-width and the next row's,
+// or at least its outermost pixel, so the outline stays connected both
+// where it's nearly horizontal and where it's nearly vertical.
+void fb_circle(uint32_t cx, uint32_t cy, uint32_t r, uint32_t color) {
+    int32_t hw = r;
+
+    for (int32_t d = 0; d <= (int32_t)r; d++) {
+        hw = circle_hw(hw, d, r);
+        int32_t next = d < (int32_t)r ? circle_hw(hw, d + 1, r) : -1;
+        uint32_t run = hw > next ? hw - next : 1;
+
+        if (next < 0) {
+            fb_hline(cx - hw, cy - d, 2 * hw + 1, color);
+            fb_hline(cx - hw, cy + d, 2 * hw + 1, color);
+            break;
+        }
+
+        fb_hline(cx - hw, cy - d, run, color);
+        fb_hline(cx + hw - run + 1, cy - d, run, color);
+        if (d) {
+            fb_hline(cx - hw, cy + d, run, color);
+            fb_hline(cx + hw - run + 1, cy + d, run, color);
+        }
+    }
+}
+
+// Bresenham, with consecutive pixels on the same row merged into one
+// span for mostly horizontal lines.
+void fb_line(uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1, uint32_t color) {
+    int32_t x = x0, y = y0;
+    int32_t dx = (int32_t)x1 - x, dy = (int32_t)y1 - y;
+    int32_t sx = dx < 0 ? -1 : 1, sy = dy < 0 ? -1 : 1;
+
+    dx *= sx;
+    dy *= sy;
+
+    if (dx >= dy) {
+        int32_t err = dx / 2, run_x = x;
+
+        for (int32_t i = 0; i <= dx; i++, x += sx) {
+            err -= dy;
+            if (err < 0 || i == dx) {
+                int32_t lo = run_x < x ? run_x : x;
+                fb_hline(lo, y, (run_x < x ? x - run_x : run_x - x) + 1, color);
+                run_x = x + sx;
+                y += sy;
+                err += dx;
             }
         }
+    } else {
+        int32_t err = dy / 2;
+
+        for (int32_t i = 0; i <= dy; i++, y += sy) {
+            fb_pixel(x, y, color);
+            err -= dx;
+            if (err < 0) {
+                x += sx;
+                err += dy;
+            }
+        }
+    }
+}
+
+void fb_triangle(uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1,
+                 uint32_t x2, uint32_t y2, uint32_t color) {
+    fb_line(x0, y0, x1, y1, color);
+    fb_line(x1, y1, x2, y2, color);
+    fb_line(x2, y2, x0, y0, color);
+}
+
+// One span per row, between the long edge (top to bottom vertex) and
+// whichever of the two short edges covers that row.
+void fb_fill_triangle(uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1,
+                      uint32_t x2, uint32_t y2, uint32_t color) {
+    int32_t ax = x0, ay = y0, bx = x1, by = y1, cx = x2, cy = y2, t;
+
+#define SWAP_VERTEX(px, py, qx, qy) \
+    do { t = px; px = qx; qx = t; t = py; py = qy; qy = t; } while (0)
+
+    if (ay > by) SWAP_VERTEX(ax, ay, bx, by);
+    if (by > cy) SWAP_VERTEX(bx, by, cx, cy);
+    if (ay > by) SWAP_VERTEX(ax, ay, bx, by);
+
+#undef SWAP_VERTEX
+
+    for (int32_t y = ay; y <= cy; y++) {
+        int32_t xl, xs;
+
+        if (cy == ay) {
+            xl = ax < bx ? (ax < cx ? ax : cx) : (bx < cx ? bx : cx);
+            xs = ax > bx ? (ax > cx ? ax : cx) : (bx > cx ? bx : cx);
+        } else {
+            xl = ax + (cx - ax) * (y - ay) / (cy - ay);
+            if (y < by)
+                xs = ax + (bx - ax) * (y - ay) / (by - ay);
+            else if (cy == by)
+                xs = bx;
+            else
+                xs = bx + (cx - bx) * (y - by) / (cy - by);
+        }
+
+        if (xl > xs) {
+            t = xl;
+            xl = xs;
+            xs = t;
+        }
+
+        fb_hline(xl, y, xs - xl + 1, color);
     }
 }
 
@@ -239,10 +941,48 @@ void fb_warning_icon(uint32_t cx, uint32_t y, uint32_t size) {
     fb_fill_circle(cx, dot_y, dot_r, FB_BLACK);
 }
 
+#ifdef CONFIG_FRAMEBUFFER_BACK_BUFFER
+// Moves drawing to a cacheable copy of the screen, so overdraw never
+// reaches the scanout buffer and fb_update_display() presents each
+// frame in one go. Stays in direct mode if LK's heap can't fit it.
+//
+// The copy is never freed, the library draws into it until LK boots
+// the kernel. Whatever LK draws on screen afterwards is only known
+// here once the board passes it to fb_mark_dirty(), otherwise the
+// next dirty area presented over it wipes it out.
+static void fb_alloc_back_buffer(void) {
+    size_t size = fb_config.stride * fb_config.phys_height;
+    void *back = malloc(size);
+
+    if (!back) {
+        printf("framebuffer: no memory for a %u byte back buffer, drawing directly\n",
+               (unsigned)size);
+        return;
+    }
+
+    // Start from what is on screen, so presenting an area we only
+    // partially drew doesn't wipe the rest of it.
+    memcpy(back, fb_config.scanout, size);
+    fb_config.buffer = back;
+}
+#endif
+
 void framebuffer_init(void) {
-    fb_init((uint32_t*)CONFIG_FRAMEBUFFER_ADDRESS,
+    fb_init((void *)CONFIG_FRAMEBUFFER_ADDRESS,
             CONFIG_FRAMEBUFFER_WIDTH,
             CONFIG_FRAMEBUFFER_HEIGHT,
             CONFIG_FRAMEBUFFER_BYTES_PER_PIXEL,
             CONFIG_FRAMEBUFFER_ALIGNMENT);
+
+#ifdef CONFIG_FRAMEBUFFER_BACK_BUFFER
+    fb_alloc_back_buffer();
+#endif
+
+#ifdef CONFIG_FRAMEBUFFER_CONSOLE
+    fb_console_init();
+#endif
+
+#ifdef CONFIG_FRAMEBUFFER_SCREENSHOT
+    fb_screenshot_init();
+#endif
 }
\ No newline at end of file
@@ -0,0 +1,70 @@
+//
+// SPDX-FileCopyrightText: 2026 Roger Ortiz <roger@r0rt1z2.com>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+
+#include <lib/debug.h>
+#include <lib/framebuffer.h>
+
+#define RLE_LITERAL 0x80
+#define RLE_COUNT   0x7F
+
+static void rle_run(uint32_t x, uint32_t y, uint32_t scale, const fb_image_t *img,
+                    uint32_t col, uint32_t row, uint32_t n, uint8_t index) {
+    if (index >= img->colors)
+        return;
+
+    uint32_t color = img->palette[index];
+    if (!(color >> 24))
+        return;
+
+    fb_fill_rect(x + col * scale, y + row * scale, n * scale, scale, color);
+}
+
+// Draws an image at (x, y), each pixel scale x scale on screen. The
+// data is decoded as it is read, every run becoming one fill, so there
+// is no intermediate bitmap and the image never needs to be unpacked.
+// Stops at the first packet that doesn't fit, so a truncated image
+// just comes out cut short.
+void fb_blit_rle(uint32_t x, uint32_t y, const fb_image_t *img, uint32_t scale) {
+    const uint8_t *p = img->data;
+    const uint8_t *end = img->data + img->size;
+    uint32_t col = 0, row = 0;
+
+    if (!scale) scale = 1;
+
+    while (p < end && row < img->height) {
+        uint8_t ctl = *p++;
+        uint32_t n = (ctl & RLE_COUNT) + 1;
+
+        if (n > img->width - col)
+            break;
+
+        if (!(ctl & RLE_LITERAL)) {
+            if (p == end)
+                break;
+            rle_run(x, y, scale, img, col, row, n, *p++);
+        } else {
+            if (n > (uint32_t)(end - p))
+                break;
+
+            // Neighbours that happen to match still go out as one span.
+            for (uint32_t i = 0, j; i < n; i = j) {
+                for (j = i + 1; j < n && p[j] == p[i]; j++);
+                rle_run(x, y, scale, img, col + i, row, j - i, p[i]);
+            }
+            p += n;
+        }
+
+        col += n;
+        if (col == img->width) {
+            col = 0;
+            row++;
+        }
+    }
+
+#if KAERU_DEBUG
+    if (row < img->height)
+        printf("fb_blit_rle: image data ends at row %u of %u\n", row, img->height);
+#endif
+}
@@ -0,0 +1,190 @@
+//
+// SPDX-FileCopyrightText: 2026 Roger Ortiz <roger@r0rt1z2.com>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+
+#include <lib/common.h>
+#include <lib/debug.h>
+#include <lib/fastboot.h>
+#include <lib/framebuffer.h>
+
+// 'fastboot oem screenshot' sends the framebuffer back as base64 in
+// INFO lines, since those are all we can reach of LK's fastboot. To
+// keep that bearable, rows are compressed against the row above them.
+// Each row is a sequence of packets, none of them crossing a row:
+//
+//   00 len           pixels copied from the row above
+//   01 len  px       one pixel repeated
+//   10 len  px ...   literal pixels
+//
+// len is the low six bits of the packet header, or, when those are
+// zero, the two bytes that follow it (little endian). Pixels are sent
+// in the panel's own format and orientation; utils/screenshot.py turns
+// the result into a PNG.
+#define SHOT_COPY    0
+#define SHOT_RUN     1
+#define SHOT_LITERAL 2
+
+#define SHOT_SHORT_MAX 63
+#define SHOT_LEN_MAX   0xFFFF
+
+#define SHOT_LINE FASTBOOT_BASE64_MAX
+
+#if defined(CONFIG_FRAMEBUFFER_FORMAT_RGB565)
+#define SHOT_FORMAT "rgb565"
+#elif defined(CONFIG_FRAMEBUFFER_FORMAT_RGB888)
+#define SHOT_FORMAT "rgb888"
+#elif defined(CONFIG_FRAMEBUFFER_FORMAT_ABGR8888)
+#define SHOT_FORMAT "abgr8888"
+#else
+#define SHOT_FORMAT "argb8888"
+#endif
+
+static uint8_t line[SHOT_LINE];
+static uint32_t line_len;
+static uint32_t total;
+static uint32_t adler_a, adler_b;
+
+static void shot_flush(void) {
+    if (!line_len) return;
+
+    // Adler-32 can take this many bytes between reductions.
+    for (uint32_t i = 0; i < line_len; i++) {
+        adler_a += line[i];
+        adler_b += adler_a;
+    }
+    adler_a %= 65521;
+    adler_b %= 65521;
+
+    fastboot_info_base64(line, line_len);
+    total += line_len;
+    line_len = 0;
+}
+
+static inline void shot_byte(uint8_t b) {
+    line[line_len++] = b;
+    if (line_len == SHOT_LINE)
+        shot_flush();
+}
+
+static void shot_bytes(const uint8_t *p, uint32_t n) {
+    while (n--)
+        shot_byte(*p++);
+}
+
+static void shot_header(uint32_t type, uint32_t len) {
+    if (len <= SHOT_SHORT_MAX) {
+        shot_byte(type << 6 | len);
+    } else {
+        shot_byte(type << 6);
+        shot_byte(len);
+        shot_byte(len >> 8);
+    }
+}
+
+static inline bool px_equal(const uint8_t *a, const uint8_t *b, uint32_t bpp) {
+    for (uint32_t i = 0; i < bpp; i++) {
+        if (a[i] != b[i])
+            return false;
+    }
+    return true;
+}
+
+// How many pixels from x on match the row above, and how many repeat
+// the pixel at x. Both stop at the end of the row.
+static uint32_t copy_len(const uint8_t *row, const uint8_t *prev, uint32_t x,
+                         uint32_t width, uint32_t bpp) {
+    uint32_t n = 0;
+
+    if (!prev) return 0;
+
+    while (x + n < width && n < SHOT_LEN_MAX &&
+           px_equal(row + (x + n) * bpp, prev + (x + n) * bpp, bpp))
+        n++;
+    return n;
+}
+
+static uint32_t run_len(const uint8_t *row, uint32_t x, uint32_t width, uint32_t bpp) {
+    uint32_t n = 1;
+
+    while (x + n < width && n < SHOT_LEN_MAX &&
+           px_equal(row + (x + n) * bpp, row + x * bpp, bpp))
+        n++;
+    return n;
+}
+
+static void shot_row(const uint8_t *row, const uint8_t *prev, uint32_t width, uint32_t bpp) {
+    uint32_t x = 0;
+
+    while (x < width) {
+        uint32_t copy = copy_len(row, prev, x, width, bpp);
+        uint32_t run = run_len(row, x, width, bpp);
+
+        if (copy >= 2 && copy >= run) {
+            shot_header(SHOT_COPY, copy);
+            x += copy;
+            continue;
+        }
+
+        if (run >= 2) {
+            shot_header(SHOT_RUN, run);
+            shot_bytes(row + x * bpp, bpp);
+            x += run;
+            continue;
+        }
+
+        // Extend the literal until something compressible starts.
+        uint32_t start = x++;
+        while (x < width && x - start < SHOT_LEN_MAX &&
+               copy_len(row, prev, x, x + 2 < width ? x + 2 : width, bpp) < 2 &&
+               run_len(row, x, x + 2 < width ? x + 2 : width, bpp) < 2)
+            x++;
+
+        shot_header(SHOT_LITERAL, x - start);
+        shot_bytes(row + start * bpp, (x - start) * bpp);
+    }
+}
+
+static void cmd_screenshot(const char* arg, void* data, unsigned sz) {
+    fb_config_t *fb = fb_get_config();
+    char buffer[64];
+
+    (void)arg;
+    (void)data;
+    (void)sz;
+
+    if (!fb->buffer) {
+        fastboot_fail("No framebuffer");
+        return;
+    }
+
+    npf_snprintf(buffer, sizeof(buffer), "screenshot %u %u %s %u",
+                 fb->phys_width, fb->phys_height, SHOT_FORMAT, fb->rotation);
+    fastboot_info(buffer);
+
+    line_len = 0;
+    total = 0;
+    adler_a = 1;
+    adler_b = 0;
+
+    const uint8_t *prev = NULL;
+    for (uint32_t y = 0; y < fb->phys_height; y++) {
+        const uint8_t *row = (const uint8_t *)fb->buffer + y * fb->stride;
+        shot_row(row, prev, fb->phys_width, fb->bppx);
+        prev = row;
+    }
+    shot_flush();
+
+    npf_snprintf(buffer, sizeof(buffer), "end %u %08x", total, adler_b << 16 | adler_a);
+    fastboot_info(buffer);
+    fastboot_okay("");
+
+#if KAERU_DEBUG
+    printf("screenshot: %u bytes for a %u byte frame\n", total,
+           fb->phys_width * fb->phys_height * fb->bppx);
+#endif
+}
+
+void fb_screenshot_init(void) {
+    fastboot_register("oem screenshot", cmd_screenshot, 1);
+}
@@ -0,0 +1,14 @@
+//
+// SPDX-FileCopyrightText: 2026 Roger Ortiz <roger@r0rt1z2.com>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+
+#include <lib/heap.h>
+
+void* malloc(size_t size) {
+    return ((void* (*)(size_t))(CONFIG_MALLOC_ADDRESS | 1))(size);
+}
+
+void free(void* ptr) {
+    ((void (*)(void*))(CONFIG_FREE_ADDRESS | 1))(ptr);
+}
@@ -23,34 +23,7 @@
 
 #include <lib/string.h>
 
-int memcmp(const void* s1, const void* s2, size_t n) {
-    if (n != 0) {
-        const unsigned char *p1 = s1, *p2 = s2;
-
-        do {
-            if (*p1++ != *p2++) return (*--p1 - *--p2);
-        } while (--n != 0);
-    }
-    return (0);
-}
-
-void* memmove(void* dest, const void* src, size_t count) {
-    unsigned char* d = (unsigned char*)dest;
-    const unsigned char* s = (const unsigned char*)src;
-
-    if (d < s || d >= s + count) {
-        for (size_t i = 0; i < count; i++) {
-            d[i] = s[i];
-        }
-    } else {
-        for (size_t i = count; i > 0; i--) {
-            d[i - 1] = s[i - 1];
-        }
-    }
-
-    return dest;
-}
-
+#ifdef CONFIG_MEMMEM_BYTEWISE
 void *memmem(const void *haystack, size_t hlen, const void *needle,
              size_t nlen) {
     int needle_first;
@@ -72,6 +45,7 @@ void *memmem(const void *haystack, size_t hlen, const void *needle,
 
     return NULL;
 }
+#endif
 
 char* strchr(const char* p, int ch) {
     for (;; ++p) {
@@ -229,6 +203,174 @@ static char* twoway_strstr(const unsigned char* h, const unsigned char* n) {
     }
 }
 
+#ifndef CONFIG_MEMMEM_BYTEWISE
+/*
+ * Same as twoway_strstr, but bounded by the end of the haystack rather
+ * than a terminator, since the LK image is full of NUL bytes.
+ */
+static void* twoway_memmem(const unsigned char* h, const unsigned char* z,
+                           const unsigned char* n, size_t l) {
+    size_t i, ip, jp, k, p, ms, p0, mem, mem0;
+    size_t byteset[32 / sizeof(size_t)] = {0};
+    size_t shift[256];
+
+    /* Computing length of needle and fill shift table */
+    for (i = 0; i < l; i++) BITOP(byteset, n[i], |=), shift[n[i]] = i + 1;
+
+    /* Compute maximal suffix */
+    ip = -1;
+    jp = 0;
+    k = p = 1;
+    while (jp + k < l) {
+        if (n[ip + k] == n[jp + k]) {
+            if (k == p) {
+                jp += p;
+                k = 1;
+            } else
+                k++;
+        } else if (n[ip + k] > n[jp + k]) {
+            jp += k;
+            k = 1;
+            p = jp - ip;
+        } else {
+            ip = jp++;
+            k = p = 1;
+        }
+    }
+    ms = ip;
+    p0 = p;
+
+    /* And with the opposite comparison */
+    ip = -1;
+    jp = 0;
+    k = p = 1;
+    while (jp + k < l) {
+        if (n[ip + k] == n[jp + k]) {
+            if (k == p) {
+                jp += p;
+                k = 1;
+            } else
+                k++;
+        } else if (n[ip + k] < n[jp + k]) {
+            jp += k;
+            k = 1;
+            p = jp - ip;
+        } else {
+            ip = jp++;
+            k = p = 1;
+        }
+    }
+    if (ip + 1 > ms + 1)
+        ms = ip;
+    else
+        p = p0;
+
+    /* Periodic needle? */
+    if (memcmp(n, n + p, ms + 1)) {
+        mem0 = 0;
+        p = MAX(ms, l - ms - 1) + 1;
+    } else
+        mem0 = l - p;
+    mem = 0;
+
+    /* Search loop */
+    for (;;) {
+        /* If remainder of haystack is shorter than needle, done */
+        if ((size_t)(z - h) < l) return 0;
+
+        /* Check last byte first; advance by shift on mismatch */
+        if (BITOP(byteset, h[l - 1], &)) {
+            k = l - shift[h[l - 1]];
+            if (k) {
+                if (k < mem) k = mem;
+                h += k;
+                mem = 0;
+                continue;
+            }
+        } else {
+            h += l;
+            mem = 0;
+            continue;
+        }
+
+        /* Compare right half */
+        for (k = MAX(ms + 1, mem); k < l && n[k] == h[k]; k++)
+            ;
+        if (k < l) {
+            h += k - ms;
+            mem = 0;
+            continue;
+        }
+        /* Compare left half */
+        for (k = ms + 1; k > mem && n[k - 1] == h[k - 1]; k--)
+            ;
+        if (k <= mem) return (void*)h;
+        h += p;
+        mem = mem0;
+    }
+}
+
+/* Needles at least this long go straight to two-way */
+#define MEMMEM_TWOWAY_MIN 32
+
+#define ONES 0x01010101u
+#define HIGHS 0x80808080u
+
+/* One bit (the high one) set in each byte of x that is zero */
+static inline uint32_t zero_bytes(uint32_t x) {
+    return ~(((x & ~HIGHS) + ~HIGHS) | x | ~HIGHS);
+}
+
+/*
+ * Word-at-a-time filter: checks four candidate positions at once for
+ * both the first and the last byte of the needle, and only compares
+ * the rest where both line up. Loads are kept word aligned, since we
+ * are built with -mno-unaligned-access.
+ */
+static void* swar_memmem(const unsigned char* h, const unsigned char* z,
+                         const unsigned char* n, size_t l) {
+    const unsigned char* last = z - l; /* last valid candidate */
+    uint32_t first = n[0] * ONES, tail = n[l - 1] * ONES;
+    size_t off = (l - 1) & 3, sh = off * 8;
+
+    for (; h <= last && ((uintptr_t)h & 3); h++) {
+        if (h[0] == n[0] && h[l - 1] == n[l - 1] && !memcmp(h + 1, n + 1, l - 2))
+            return (void*)h;
+    }
+
+    for (; h + 3 <= last; h += 4) {
+        const uint32_t* e = (const uint32_t*)(h + (l - 1 - off));
+        uint32_t a = *(const uint32_t*)h;
+        uint32_t b = sh ? (e[0] >> sh) | (e[1] << (32 - sh)) : e[0];
+        uint32_t m = zero_bytes(a ^ first) & zero_bytes(b ^ tail);
+
+        while (m) {
+            size_t i = __builtin_ctz(m) >> 3;
+            if (!memcmp(h + i + 1, n + 1, l - 2)) return (void*)(h + i);
+            m &= m - 1;
+        }
+    }
+
+    for (; h <= last; h++) {
+        if (h[0] == n[0] && h[l - 1] == n[l - 1] && !memcmp(h + 1, n + 1, l - 2))
+            return (void*)h;
+    }
+
+    return 0;
+}
+
+void* memmem(const void* haystack, size_t hlen, const void* needle, size_t nlen) {
+    const unsigned char* h = haystack;
+    const unsigned char* n = needle;
+
+    if (!nlen || nlen > hlen) return NULL;
+    if (nlen == 1) return memchr(h, n[0], hlen);
+    if (nlen >= MEMMEM_TWOWAY_MIN) return twoway_memmem(h, h + hlen, n, nlen);
+
+    return swar_memmem(h, h + hlen, n, nlen);
+}
+#endif
+
 char* strstr(const char* h, const char* n) {
     /* Return immediately on empty needle */
     if (!n[0]) return (char*)h;
@@ -261,14 +403,6 @@ int strncmp(const char* s1, const char* s2, size_t n) {
     return (0);
 }
 
-size_t strlen(const char* str) {
-    const char* s;
-
-    for (s = str; *s; ++s)
-        ;
-    return (s - str);
-}
-
 size_t strnlen(char const *s, size_t count)
 {
 	const char *sc;
@@ -0,0 +1,50 @@
+//
+// SPDX-FileCopyrightText: 2026 Roger Ortiz <roger@r0rt1z2.com>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+
+#include <stdbool.h>
+
+#include <arch/cache.h>
+#include <lib/common.h>
+#include <lib/patch.h>
+
+static struct {
+    uint32_t depth;
+    bool icache_dirty;
+} tx;
+
+void patch_begin(void) {
+#ifdef CONFIG_PATCH_BATCHING
+    tx.depth++;
+#endif
+}
+
+void patch_flush(void) {
+    if (tx.icache_dirty) {
+        arch_invalidate_icache();
+        tx.icache_dirty = false;
+    }
+}
+
+void patch_commit(void) {
+    if (!tx.depth)
+        return;
+
+    if (--tx.depth == 0)
+        patch_flush();
+}
+
+// The data cache is cleaned right away even inside a transaction, so
+// the new instructions are always in memory. Only the icache
+// invalidate, which throws away the whole icache each time, is left
+// for commit.
+void patch_sync_range(uintptr_t start, size_t size) {
+    if (!tx.depth) {
+        arch_sync_cache_range(start, size);
+        return;
+    }
+
+    arch_clean_invalidate_cache_range(start, size);
+    tx.icache_dirty = true;
+}
@@ -0,0 +1,123 @@
+//
+// SPDX-FileCopyrightText: 2026 Roger Ortiz <roger@r0rt1z2.com>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+
+#include <lib/common.h>
+#include <lib/debug.h>
+#include <lib/fastboot.h>
+#include <lib/profiler.h>
+
+// PMCR.D makes the counter tick once every 64 cycles, so it takes a
+// few minutes to wrap instead of a few seconds. That is plenty of
+// resolution for boot phases and lets a single 32-bit read cover the
+// whole time LK spends between our early and late init.
+#define PMCR_E (1 << 0)
+#define PMCR_D (1 << 3)
+#define PMCNTEN_C (1u << 31)
+#define CYCLES_PER_TICK 64
+
+#define NAME_PREFIX "kaeru-boottime-"
+
+typedef struct {
+    const char* name;
+    uint32_t ticks;
+    bool lk;
+} profile_mark_t;
+
+static profile_mark_t marks[CONFIG_BOOT_PROFILER_MARKS];
+static uint32_t count;
+
+// fastboot_publish() keeps the pointers, so these have to outlive us.
+static char var_names[CONFIG_BOOT_PROFILER_MARKS][48];
+static char var_values[CONFIG_BOOT_PROFILER_MARKS + 1][12];
+
+static inline uint32_t read_ticks(void) {
+    uint32_t val;
+    asm volatile("mrc p15, 0, %0, c9, c13, 0" : "=r"(val));
+    return val;
+}
+
+// Starts the cycle counter without resetting it, in case LK or a
+// previous stage is already using it.
+static void counter_enable(void) {
+    uint32_t pmcr;
+
+    asm volatile("mrc p15, 0, %0, c9, c12, 0" : "=r"(pmcr));
+    pmcr |= PMCR_E | PMCR_D;
+    asm volatile("mcr p15, 0, %0, c9, c12, 0" :: "r"(pmcr));
+    asm volatile("mcr p15, 0, %0, c9, c12, 1" :: "r"(PMCNTEN_C));
+    asm volatile("isb");
+}
+
+// Split so it doesn't overflow or need a 64-bit division.
+static uint32_t ticks_to_us(uint32_t ticks) {
+    uint32_t mhz = CONFIG_BOOT_PROFILER_CPU_MHZ;
+
+    return (ticks / mhz) * CYCLES_PER_TICK + ((ticks % mhz) * CYCLES_PER_TICK) / mhz;
+}
+
+static uint32_t phase_us(uint32_t i) {
+    return ticks_to_us(marks[i + 1].ticks - marks[i].ticks);
+}
+
+static uint32_t total_us(void) {
+    uint32_t total = 0;
+
+    for (uint32_t i = 0; i + 1 < count; i++) {
+        if (!marks[i].lk)
+            total += phase_us(i);
+    }
+
+    return total;
+}
+
+void profiler_mark(const char* name, bool lk) {
+    if (!count)
+        counter_enable();
+
+    if (count >= CONFIG_BOOT_PROFILER_MARKS)
+        return;
+
+    marks[count].name = name;
+    marks[count].lk = lk;
+    marks[count].ticks = read_ticks();
+    count++;
+}
+
+static void cmd_boottime(const char* arg, void* data, unsigned sz) {
+    char buffer[64];
+
+    (void)arg;
+    (void)data;
+    (void)sz;
+
+    for (uint32_t i = 0; i + 1 < count; i++) {
+        npf_snprintf(buffer, sizeof(buffer), "%-18s %8u us%s", marks[i].name,
+                     phase_us(i), marks[i].lk ? " (lk)" : "");
+        fastboot_info(buffer);
+    }
+
+    npf_snprintf(buffer, sizeof(buffer), "%-18s %8u us", "total", total_us());
+    fastboot_info(buffer);
+    fastboot_okay("");
+}
+
+// Called right before handing control back to LK, once the last phase
+// has been closed.
+void profiler_publish(void) {
+    for (uint32_t i = 0; i + 1 < count; i++) {
+        npf_snprintf(var_names[i], sizeof(var_names[i]), NAME_PREFIX "%s", marks[i].name);
+        npf_snprintf(var_values[i], sizeof(var_values[i]), "%u", phase_us(i));
+        fastboot_publish(var_names[i], var_values[i]);
+
+#if KAERU_DEBUG
+        printf("boottime: %s %u us\n", marks[i].name, phase_us(i));
+#endif
+    }
+
+    npf_snprintf(var_values[CONFIG_BOOT_PROFILER_MARKS],
+                 sizeof(var_values[CONFIG_BOOT_PROFILER_MARKS]), "%u", total_us());
+    fastboot_publish(NAME_PREFIX "total", var_values[CONFIG_BOOT_PROFILER_MARKS]);
+    fastboot_register("oem boottime", cmd_boottime, 1);
+}
@@ -0,0 +1,197 @@
+//
+// SPDX-FileCopyrightText: 2026 Roger Ortiz <roger@r0rt1z2.com>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+
+#include <stddef.h>
+
+#include <lib/common.h>
+#include <lib/debug.h>
+#include <lib/fastboot.h>
+#include <lib/ramlog.h>
+
+#include <wdt/mtk_wdt.h>
+
+#define SLOT_SIZE (CONFIG_RAMLOG_SIZE / 2)
+#define DATA_SIZE (SLOT_SIZE - sizeof(ramlog_header_t))
+
+// INFO text that fits LK's 64 byte response buffer.
+#define INFO_MAX 59
+
+static ramlog_header_t *current = NULL;
+static const ramlog_header_t *previous = NULL;
+static uint32_t reset_status;
+
+static inline ramlog_header_t *slot(uint32_t i) {
+    return (ramlog_header_t *)(CONFIG_RAMLOG_ADDRESS + i * SLOT_SIZE);
+}
+
+static inline char *slot_data(const ramlog_header_t *h) {
+    return (char *)(h + 1);
+}
+
+// Nibble at a time, which is plenty for a header and saves the 1 KiB
+// a full table would cost.
+static uint32_t crc32(const void *data, size_t len) {
+    static const uint32_t table[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC,
+        0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+        0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+    };
+    const uint8_t *p = data;
+    uint32_t crc = ~0u;
+
+    while (len--) {
+        crc = table[(crc ^ *p) & 0xF] ^ (crc >> 4);
+        crc = table[(crc ^ (*p++ >> 4)) & 0xF] ^ (crc >> 4);
+    }
+
+    return ~crc;
+}
+
+static inline uint32_t header_crc(const ramlog_header_t *h) {
+    return crc32(h, offsetof(ramlog_header_t, crc));
+}
+
+// A cold boot leaves random data behind, which is what the CRC is for.
+static bool slot_valid(const ramlog_header_t *h) {
+    return h->magic == RAMLOG_MAGIC && h->size == DATA_SIZE && h->crc == header_crc(h);
+}
+
+// The header is written back every time, and cleaned out of the cache
+// along with the data, since a watchdog reset doesn't flush anything.
+static void ramlog_sink(const char *buf, size_t len) {
+    uint32_t pos = current->head % DATA_SIZE;
+    char *data = slot_data(current);
+
+    if (len > DATA_SIZE) {
+        buf += len - DATA_SIZE;
+        current->head += len - DATA_SIZE;
+        len = DATA_SIZE;
+        pos = current->head % DATA_SIZE;
+    }
+
+    size_t first = len < DATA_SIZE - pos ? len : DATA_SIZE - pos;
+
+    memcpy(data + pos, buf, first);
+    arch_clean_cache_range((uintptr_t)(data + pos), first);
+
+    if (first < len) {
+        memcpy(data, buf + first, len - first);
+        arch_clean_cache_range((uintptr_t)data, len - first);
+    }
+
+    current->head += len;
+    current->crc = header_crc(current);
+    arch_clean_cache_range((uintptr_t)current, sizeof(*current));
+}
+
+static const char *reset_reason(uint32_t status) {
+    if (status & MTK_WDT_STATUS_HWWDT_RST)
+        return "watchdog timeout";
+    if (status & MTK_WDT_STATUS_SWWDT_RST)
+        return "software reset";
+    if (status & MTK_WDT_STATUS_IRQWDT_RST)
+        return "watchdog irq";
+    return "unknown";
+}
+
+// Runs first thing in kaeru's early init, so the rest of it ends up
+// in the log. Whichever slot holds the newest valid log is kept for
+// 'oem lastlog', and this boot takes over the other one.
+void ramlog_init(void) {
+    const ramlog_header_t *a = slot(0), *b = slot(1);
+    uint32_t boot = 0;
+
+    reset_status = mtk_wdt_status();
+
+    if (slot_valid(a) && (!slot_valid(b) || (int32_t)(a->boot - b->boot) > 0))
+        previous = a;
+    else if (slot_valid(b))
+        previous = b;
+
+    current = previous == a ? slot(1) : slot(0);
+    if (previous)
+        boot = previous->boot + 1;
+
+    current->magic = RAMLOG_MAGIC;
+    current->boot = boot;
+    current->size = DATA_SIZE;
+    current->head = 0;
+    current->crc = header_crc(current);
+    arch_clean_cache_range((uintptr_t)current, sizeof(*current));
+
+    log_sink_register(ramlog_sink);
+
+    if (previous) {
+        printf("ramlog: boot %u, last one (%u bytes) ended by %s (0x%08X)\n",
+               boot, previous->head, reset_reason(reset_status), reset_status);
+    }
+}
+
+// Sends one line, or INFO_MAX characters of it. INFO responses are
+// text, so anything unprintable goes out as a dot.
+static void send_line(const char *data, uint32_t start, uint32_t len) {
+    char line[INFO_MAX + 1];
+
+    for (uint32_t i = 0; i < len; i++) {
+        char c = data[(start + i) % DATA_SIZE];
+        line[i] = (c >= 32 && c < 127) || c == '\t' ? c : '.';
+    }
+    line[len] = '\0';
+
+    fastboot_info(line);
+}
+
+static void cmd_lastlog(const char* arg, void* data, unsigned sz) {
+    char buffer[64];
+
+    (void)arg;
+    (void)data;
+    (void)sz;
+
+    if (!previous) {
+        fastboot_fail("No log from the previous boot");
+        return;
+    }
+
+    const char *log = slot_data(previous);
+    uint32_t len = previous->head < DATA_SIZE ? previous->head : DATA_SIZE;
+    uint32_t start = previous->head - len;
+
+    npf_snprintf(buffer, sizeof(buffer), "boot %u, ended by %s (0x%08X)",
+                 previous->boot, reset_reason(reset_status), reset_status);
+    fastboot_info(buffer);
+
+    // Once the ring has wrapped, the first line is missing its start.
+    if (start) {
+        while (len && log[start % DATA_SIZE] != '\n') {
+            start++;
+            len--;
+        }
+        if (len) {
+            start++;
+            len--;
+        }
+    }
+
+    for (uint32_t pos = 0; pos < len;) {
+        uint32_t n = 0;
+
+        while (pos + n < len && n < INFO_MAX && log[(start + pos + n) % DATA_SIZE] != '\n')
+            n++;
+
+        send_line(log, start + pos, n);
+
+        pos += n;
+        if (pos < len && log[(start + pos) % DATA_SIZE] == '\n')
+            pos++;
+    }
+
+    fastboot_okay("");
+}
+
+void ramlog_publish(void) {
+    fastboot_register("oem lastlog", cmd_lastlog, 1);
+}
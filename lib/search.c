@@ -0,0 +1,208 @@
+//
+// SPDX-FileCopyrightText: 2026 Roger Ortiz <roger@r0rt1z2.com>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+
+#include <stdbool.h>
+
+#include <lib/debug.h>
+#include <lib/search.h>
+#include <lib/string.h>
+
+#define SEARCH_BUCKETS 256
+#define SEARCH_NONE 0xFF
+
+static inline uint32_t search_bucket(uint16_t value) {
+    return (value ^ (value >> 8)) & (SEARCH_BUCKETS - 1);
+}
+
+static inline uint16_t search_value(const search_pattern_t* p, uint32_t i) {
+    return p->masked ? p->masked[i].value : p->pattern[i];
+}
+
+static inline uint16_t search_mask(const search_pattern_t* p, uint32_t i) {
+    return p->masked ? p->masked[i].mask : 0xFFFF;
+}
+
+// Picks the halfword we key the scan on: the one with the most bits
+// to compare, so wildcards never end up driving the search.
+static uint32_t search_anchor(const search_mask_t* pattern, size_t count) {
+    uint32_t best = 0;
+    int best_bits = -1;
+
+    for (uint32_t i = 0; i < count; i++) {
+        int bits = __builtin_popcount(pattern[i].mask);
+        if (bits > best_bits) {
+            best = i;
+            best_bits = bits;
+            if (bits == 16) break;
+        }
+    }
+
+    return best;
+}
+
+static bool search_match(const search_pattern_t* p, const uint16_t* cur) {
+    if (!p->masked) {
+        for (uint32_t i = 0; i < p->count; i++) {
+            if (cur[i] != p->pattern[i]) return false;
+        }
+        return true;
+    }
+
+    for (uint32_t i = 0; i < p->count; i++) {
+        if ((cur[i] & p->masked[i].mask) != p->masked[i].value) return false;
+    }
+    return true;
+}
+
+// A cached address is only trusted if the signature still matches
+// there, so a stale or foreign cache entry just costs us a scan.
+static bool search_cached_valid(const search_pattern_t* p, uint32_t addr,
+                                uint32_t start, uint32_t max_addr) {
+    if (!addr || addr < start || addr >= max_addr)
+        return false;
+
+    return search_match(p, (const uint16_t*)addr);
+}
+
+// Finds the first match of a masked signature in [start, end).
+//
+// Only the anchor halfword is tested at every position; the rest of
+// the signature is compared once that one lines up.
+uint32_t search_pattern_masked(uint32_t start, uint32_t end,
+                               const search_mask_t* pattern, size_t count) {
+    if (!count)
+        return 0;
+
+    uint32_t anchor = search_anchor(pattern, count);
+    uint16_t value = pattern[anchor].value;
+    uint16_t mask = pattern[anchor].mask;
+    search_pattern_t p = {.masked = pattern, .count = count};
+    uint32_t key = search_cache_key(&p, start);
+
+    uint32_t max_addr = end - (count * 2);
+    uint32_t cached = search_cache_get(key);
+    if (search_cached_valid(&p, cached, start, max_addr))
+        return cached;
+
+    for (uint32_t offset = start; offset < max_addr; offset += 2) {
+        const uint16_t* cur = (const uint16_t*)offset;
+
+        if ((cur[anchor] & mask) != value) continue;
+        if (search_match(&p, cur)) {
+            search_cache_put(key, offset);
+            return offset;
+        }
+    }
+
+    return 0;
+}
+
+// Resolves every signature in one pass over [start, end).
+//
+// Calling SEARCH_PATTERN once per signature walks the whole image
+// each time, so boards with a dozen of them pay for a dozen scans.
+// Instead, we hash each signature by its anchor halfword into a small
+// dispatch table and only compare the ones sharing a bucket with the
+// halfword we're currently looking at.
+//
+// Masked signatures whose anchor still has wildcard bits can't be
+// hashed, so those are tested at every position instead.
+//
+// Signatures the search cache already knows about are checked in
+// place and never enter the scan, so if all of them are cached the
+// image isn't walked at all.
+//
+// Like SEARCH_PATTERN, the first match wins. Returns the number of
+// signatures that were found, or -1 if the batch is too big.
+int search_patterns(uint32_t start, uint32_t end, search_pattern_t* patterns, size_t count) {
+    uint8_t head[SEARCH_BUCKETS];
+    uint8_t next[SEARCH_BATCH_MAX];
+    uint16_t anchor[SEARCH_BATCH_MAX];
+    uint32_t key[SEARCH_BATCH_MAX];
+    uint8_t slow = SEARCH_NONE;
+    size_t pending = 0;
+    int found = 0;
+
+    if (count > SEARCH_BATCH_MAX)
+        return -1;
+
+    memset(head, SEARCH_NONE, sizeof(head));
+
+    for (size_t i = 0; i < count; i++) {
+        search_pattern_t* p = &patterns[i];
+
+        p->result = 0;
+        if (!p->count)
+            continue;
+
+        key[i] = search_cache_key(p, start);
+        uint32_t cached = search_cache_get(key[i]);
+        if (search_cached_valid(p, cached, start, end - (p->count * 2))) {
+            p->result = cached;
+            found++;
+            TRACE("search: signature %u cached at 0x%08X\n", i, cached);
+            continue;
+        }
+
+        anchor[i] = p->masked ? search_anchor(p->masked, p->count) : 0;
+
+        if (search_mask(p, anchor[i]) == 0xFFFF) {
+            uint32_t b = search_bucket(search_value(p, anchor[i]));
+            next[i] = head[b];
+            head[b] = (uint8_t)i;
+        } else {
+            next[i] = slow;
+            slow = (uint8_t)i;
+        }
+
+        pending++;
+    }
+
+    for (uint32_t offset = start; pending && offset + 2 <= end; offset += 2) {
+        uint16_t value = *(const uint16_t*)offset;
+
+        for (uint8_t i = head[search_bucket(value)]; i != SEARCH_NONE; i = next[i]) {
+            search_pattern_t* p = &patterns[i];
+            uint32_t at = offset - (anchor[i] * 2);
+
+            if (p->result || search_value(p, anchor[i]) != value)
+                continue;
+
+            // Same bound SEARCH_PATTERN uses, so both agree on
+            // matches that sit right at the edges of the range.
+            if (at < start || at >= end - (p->count * 2))
+                continue;
+
+            if (search_match(p, (const uint16_t*)at)) {
+                p->result = at;
+                search_cache_put(key[i], at);
+                pending--;
+                found++;
+                TRACE("search: signature %u found at 0x%08X\n", i, at);
+            }
+        }
+
+        for (uint8_t i = slow; i != SEARCH_NONE; i = next[i]) {
+            search_pattern_t* p = &patterns[i];
+
+            if (p->result || offset >= end - (p->count * 2))
+                continue;
+
+            if (search_match(p, (const uint16_t*)offset)) {
+                p->result = offset;
+                search_cache_put(key[i], offset);
+                pending--;
+                found++;
+                TRACE("search: masked signature %u found at 0x%08X\n", i, offset);
+            }
+        }
+    }
+
+#if KAERU_DEBUG
+    printf("search_patterns: resolved %d/%u signatures\n", found, (unsigned)count);
+#endif
+
+    return found;
+}
@@ -0,0 +1,293 @@
+//
+// SPDX-FileCopyrightText: 2026 Roger Ortiz <roger@r0rt1z2.com>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+
+#include <stdbool.h>
+
+#include <arch/cache.h>
+#include <lib/common.h>
+#include <lib/debug.h>
+#include <lib/search.h>
+#include <lib/string.h>
+
+#if defined(CONFIG_SEARCH_CACHE_BACKEND_ENV)
+#include <lib/environment.h>
+#elif defined(CONFIG_SEARCH_CACHE_BACKEND_PARTITION)
+#include <lib/mt_part.h>
+#include <lib/storage.h>
+#endif
+
+// Bumped whenever the keys change, so old tables are dropped instead
+// of filling up with entries nothing looks up anymore.
+#define SEARCH_CACHE_MAGIC 0x3243534B // "KSC2"
+
+#define FNV_OFFSET 0x811C9DC5
+#define FNV_PRIME 0x01000193
+
+struct search_cache_entry {
+    uint32_t key;
+    uint32_t offset;
+};
+
+// On-disk layout for the partition backend, and the in-memory table
+// for both. Padded to a block so it can be written out as is.
+static union {
+    struct {
+        uint32_t magic;
+        uint32_t digest;
+        uint32_t count;
+        uint32_t reserved;
+        struct search_cache_entry entries[CONFIG_SEARCH_CACHE_ENTRIES];
+    };
+    uint8_t raw[ROUNDUP(16 + CONFIG_SEARCH_CACHE_ENTRIES * 8, 512)];
+} cache;
+
+static uint32_t digest;
+static bool loaded;
+static bool dirty;
+
+static inline uint32_t fnv_word(uint32_t hash, uint32_t word) {
+    return (hash ^ word) * FNV_PRIME;
+}
+
+static bool search_cache_valid(void) {
+    return cache.magic == SEARCH_CACHE_MAGIC && cache.digest == digest &&
+           cache.count <= CONFIG_SEARCH_CACHE_ENTRIES;
+}
+
+// The table is also kept in DRAM, followed by a checksum of it. A warm
+// reboot leaves it there for the next boot to pick up in early init,
+// long before the env or storage are up. After a cold boot that memory
+// is just noise, which is what the checksum is for.
+static uint32_t ram_checksum(const uint8_t* table) {
+    uint32_t hash = FNV_OFFSET;
+
+    for (uint32_t i = 0; i < sizeof(cache.raw); i += 4)
+        hash = fnv_word(hash, *(const uint32_t*)(table + i));
+
+    return hash;
+}
+
+static void search_cache_ram_load(void) {
+    const uint8_t* copy = (const uint8_t*)CONFIG_SEARCH_CACHE_RAM_ADDRESS;
+
+    if (*(const uint32_t*)(copy + sizeof(cache.raw)) != ram_checksum(copy))
+        return;
+
+    memcpy(cache.raw, copy, sizeof(cache.raw));
+
+    if (!search_cache_valid()) {
+        memset(&cache, 0, sizeof(cache));
+        return;
+    }
+
+    printf("Loaded %u cached addresses from RAM\n", cache.count);
+    loaded = true;
+}
+
+static void search_cache_ram_store(void) {
+    uint8_t* copy = (uint8_t*)CONFIG_SEARCH_CACHE_RAM_ADDRESS;
+
+    memcpy(copy, cache.raw, sizeof(cache.raw));
+    *(uint32_t*)(copy + sizeof(cache.raw)) = ram_checksum(cache.raw);
+
+    // A watchdog reset doesn't flush anything.
+    arch_clean_cache_range((uintptr_t)copy, sizeof(cache.raw) + 4);
+}
+
+// Hashes one word per cache line of LK. We only need to tell two LK
+// builds apart here: every cached address is checked against its
+// signature before it's handed out, so sampling is good enough and
+// keeps this well under a millisecond.
+//
+// Only code and read-only data may be hashed, or LK's own writes to
+// .data would change the digest, and rewrite the cache, every boot.
+// Unless told otherwise, we stop at LK's '.apps' table, which its
+// linker script puts at the very end of .rodata.
+void search_cache_init(void) {
+    uint32_t end = LK_START + CONFIG_SEARCH_CACHE_DIGEST_SIZE;
+    uint32_t hash = FNV_OFFSET;
+
+    if (!CONFIG_SEARCH_CACHE_DIGEST_SIZE) {
+        for (end = LK_START; end < LK_END; end += 4) {
+            if (*(const uint32_t*)end == (CONFIG_APP_ADDRESS | 1))
+                break;
+        }
+    }
+
+    if (end > LK_END)
+        end = LK_END;
+
+    for (uint32_t addr = LK_START; addr < end; addr += CONFIG_CACHE_LINE)
+        hash = fnv_word(hash, *(const uint32_t*)addr);
+
+    digest = hash;
+
+    if (CONFIG_SEARCH_CACHE_RAM_ADDRESS)
+        search_cache_ram_load();
+}
+
+// Identifies a signature by its contents rather than by where it's
+// used, so boards don't have to number their lookups and a kaeru
+// update never hands out an address meant for another signature.
+//
+// What we store is the first match from start, and the same signature
+// searched from somewhere else may well resolve to an earlier one, so
+// start is part of the key too. The end of the range doesn't need to
+// be: a shorter range either still contains that first match or has
+// no match at all, which search_cached_valid() catches.
+uint32_t search_cache_key(const search_pattern_t* p, uint32_t start) {
+    uint32_t hash = fnv_word(fnv_word(FNV_OFFSET, start), p->count);
+
+    for (uint32_t i = 0; i < p->count; i++) {
+        if (p->masked)
+            hash = fnv_word(hash, p->masked[i].value | (p->masked[i].mask << 16));
+        else
+            hash = fnv_word(hash, p->pattern[i] | 0xFFFF0000);
+    }
+
+    return hash;
+}
+
+uint32_t search_cache_get(uint32_t key) {
+    if (!loaded)
+        return 0;
+
+    for (uint32_t i = 0; i < cache.count; i++) {
+        if (cache.entries[i].key == key)
+            return LK_START + cache.entries[i].offset;
+    }
+
+    return 0;
+}
+
+void search_cache_put(uint32_t key, uint32_t addr) {
+    uint32_t offset = addr - LK_START;
+
+    if (!loaded || addr < LK_START || addr >= LK_END)
+        return;
+
+    for (uint32_t i = 0; i < cache.count; i++) {
+        if (cache.entries[i].key == key) {
+            if (cache.entries[i].offset != offset) {
+                cache.entries[i].offset = offset;
+                dirty = true;
+            }
+            return;
+        }
+    }
+
+    if (cache.count >= CONFIG_SEARCH_CACHE_ENTRIES)
+        return;
+
+    cache.entries[cache.count].key = key;
+    cache.entries[cache.count].offset = offset;
+    cache.count++;
+    dirty = true;
+}
+
+#if defined(CONFIG_SEARCH_CACHE_BACKEND_ENV)
+// The env backend stores the table as "digest;key:offset;..." in hex,
+// since LK's env only holds strings.
+#define SEARCH_CACHE_ENV_MAX (9 + CONFIG_SEARCH_CACHE_ENTRIES * 15 + 1)
+
+static bool search_cache_read(void) {
+    char* val = get_env(KAERU_ENV_SEARCH_CACHE);
+    char* end;
+
+    if (!val)
+        return false;
+
+    cache.digest = strtoul(val, &end, 16);
+    cache.count = 0;
+
+    while (*end == ';' && cache.count < CONFIG_SEARCH_CACHE_ENTRIES) {
+        struct search_cache_entry* e = &cache.entries[cache.count];
+
+        e->key = strtoul(end + 1, &end, 16);
+        if (*end != ':')
+            break;
+        e->offset = strtoul(end + 1, &end, 16);
+        cache.count++;
+    }
+
+    cache.magic = SEARCH_CACHE_MAGIC;
+    return true;
+}
+
+static bool search_cache_write(void) {
+    static char buf[SEARCH_CACHE_ENV_MAX];
+    int len = npf_snprintf(buf, sizeof(buf), "%08x", cache.digest);
+
+    for (uint32_t i = 0; i < cache.count; i++) {
+        len += npf_snprintf(buf + len, sizeof(buf) - len, ";%x:%x",
+                            cache.entries[i].key, cache.entries[i].offset);
+    }
+
+    return set_env(KAERU_ENV_SEARCH_CACHE, buf) >= 0;
+}
+#elif defined(CONFIG_SEARCH_CACHE_BACKEND_PARTITION)
+static bool search_cache_read(void) {
+    const struct part_info* part = storage_part_find(CONFIG_SEARCH_CACHE_PARTITION);
+
+    if (!part)
+        return false;
+
+    return storage_part_read(part, cache.raw, CONFIG_SEARCH_CACHE_OFFSET,
+                             sizeof(cache.raw)) == sizeof(cache.raw);
+}
+
+static bool search_cache_write(void) {
+    const struct part_info* part = storage_part_find(CONFIG_SEARCH_CACHE_PARTITION);
+
+    if (!part)
+        return false;
+
+    return storage_part_write(part, cache.raw, CONFIG_SEARCH_CACHE_OFFSET,
+                              sizeof(cache.raw)) == sizeof(cache.raw);
+}
+#endif
+
+// Needs the env or storage to be up, so this can only run from late
+// init onwards: LK reads both in platform_init(), after kaeru's early
+// init has returned. Unless the table was already found in RAM,
+// lookups done before then (i.e. from board_early_init) always scan,
+// and aren't recorded either.
+void search_cache_load(void) {
+    // What's stored was written along with the RAM copy, so it can't
+    // be any newer than that.
+    if (loaded)
+        return;
+
+    if (!search_cache_read() || !search_cache_valid()) {
+        // First boot or a different LK: start over, and let the scans
+        // that follow fill the table back up.
+        memset(&cache, 0, sizeof(cache));
+        cache.magic = SEARCH_CACHE_MAGIC;
+        cache.digest = digest;
+        printf("Search cache is stale, falling back to full scans\n");
+    } else {
+        printf("Loaded %u cached addresses (digest 0x%08x)\n", cache.count, digest);
+    }
+
+    loaded = true;
+}
+
+void search_cache_save(void) {
+    if (!loaded)
+        return;
+
+    if (CONFIG_SEARCH_CACHE_RAM_ADDRESS)
+        search_cache_ram_store();
+
+    if (!dirty)
+        return;
+
+    if (!search_cache_write()) {
+        printf("Failed to store the search cache\n");
+        return;
+    }
+
+    dirty = false;
+}
@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: AGPL-3.0-or-later
 //
 
+#include <lib/patch.h>
 #include <lib/thread.h>
 
 thread_t *thread_create(const char *name, thread_start_routine entry, void *arg, int priority, size_t stack_size) {
@@ -11,6 +12,10 @@ thread_t *thread_create(const char *name, thread_start_routine entry, void *arg,
 }
 
 int thread_resume(thread_t *t) {
+    // The new thread may get scheduled right away, so make sure
+    // anything patched so far is visible before it runs.
+    patch_flush();
+
     return ((int (*)(thread_t *))
             (CONFIG_THREAD_RESUME_ADDRESS | 1))(t);
 }
@@ -0,0 +1,82 @@
+//
+// SPDX-FileCopyrightText: 2026 Roger Ortiz <roger@r0rt1z2.com>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+
+#include <stdarg.h>
+
+#include <lib/common.h>
+#include <lib/debug.h>
+#include <lib/fastboot.h>
+#include <lib/trace.h>
+
+// Every entry takes a fixed slot, whatever its argument count, so the
+// ring can be read back from any point without having to find where
+// an entry starts.
+#define TRACE_VALID (1u << 31)
+#define TRACE_ID_MASK 0xFFFFFF
+
+// Set by start.S. kaeru is linked at 0 but runs wherever it was loaded,
+// so every address it computes is off by this much.
+extern uint32_t kaeru_load_base;
+
+typedef struct {
+    uint32_t header; // TRACE_VALID | nargs << 24 | format offset
+    uint32_t args[TRACE_MAX_ARGS];
+} trace_entry_t;
+
+static trace_entry_t ring[CONFIG_TRACE_ENTRIES];
+static uint32_t next = 0;
+static uint32_t total = 0;
+
+// No locking: an entry is claimed before it is filled in, so a thread
+// that preempts us gets a slot of its own, and the worst a race can do
+// is leave one entry half written.
+void trace_record(uint32_t id, uint32_t nargs, ...) {
+    trace_entry_t *e = &ring[next];
+    va_list args;
+
+    next = next + 1 == CONFIG_TRACE_ENTRIES ? 0 : next + 1;
+    total++;
+
+    va_start(args, nargs);
+    for (uint32_t i = 0; i < nargs; i++)
+        e->args[i] = va_arg(args, uint32_t);
+    va_end(args);
+
+    e->header = TRACE_VALID | nargs << 24 | ((id - kaeru_load_base) & TRACE_ID_MASK);
+}
+
+// Sends the ring oldest entry first, as base64 in INFO lines, each
+// one entry's header followed by its arguments. The load offset goes
+// in the first line, so %s arguments can be looked up in kaeru.o.
+static void cmd_trace(const char* arg, void* data, unsigned sz) {
+    char buffer[64];
+    uint32_t sent = 0;
+
+    (void)arg;
+    (void)data;
+    (void)sz;
+
+    npf_snprintf(buffer, sizeof(buffer), "trace %u %08x", total, kaeru_load_base);
+    fastboot_info(buffer);
+
+    for (uint32_t i = 0; i < CONFIG_TRACE_ENTRIES; i++) {
+        const trace_entry_t *e = &ring[(next + i) % CONFIG_TRACE_ENTRIES];
+        uint32_t nargs = (e->header >> 24) & 0x7F;
+
+        if (!(e->header & TRACE_VALID) || nargs > TRACE_MAX_ARGS)
+            continue;
+
+        fastboot_info_base64(e, (1 + nargs) * sizeof(uint32_t));
+        sent++;
+    }
+
+    npf_snprintf(buffer, sizeof(buffer), "end %u", sent);
+    fastboot_info(buffer);
+    fastboot_okay("");
+}
+
+void trace_init(void) {
+    fastboot_register("oem trace", cmd_trace, 1);
+}
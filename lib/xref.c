@@ -0,0 +1,175 @@
+//
+// SPDX-FileCopyrightText: 2026 Roger Ortiz <roger@r0rt1z2.com>
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+
+#include <stdbool.h>
+
+#include <lib/debug.h>
+#include <lib/xref.h>
+
+// How far back xref_func_start() looks for a prologue before giving up.
+#define XREF_FUNC_MAX 0x4000
+
+// How many halfwords after a literal load we look for the 'add rX, pc'
+// that turns it into an address, for LKs built with -fPIC.
+#define XREF_PIC_WINDOW 8
+
+#define HW(addr) (*(volatile uint16_t*)(addr))
+#define WORD(addr) (*(volatile uint32_t*)(addr))
+
+// Thumb PC as seen by literal loads and ADR: 4 bytes ahead, word aligned.
+#define THUMB_PC(addr) (((addr) + 4) & ~3)
+
+// Finds the closest PUSH {..., lr} or STMDB sp!, {..., lr} at or before
+// addr. This is a heuristic: a leaf function without a prologue will
+// resolve to whatever function precedes it.
+uint32_t xref_func_start(uint32_t addr, uint32_t limit) {
+    addr &= ~1;
+
+    for (uint32_t a = addr; a >= limit && addr - a < XREF_FUNC_MAX; a -= 2) {
+        uint16_t hw = HW(a);
+
+        if ((hw & 0xFF00) == 0xB500)
+            return a;
+
+        if (hw == 0xE92D && (HW(a + 2) & 0xE000) == 0x4000)
+            return a;
+
+        if (a < 2)
+            break;
+    }
+
+    return 0;
+}
+
+// Looks for 'add rd, pc' shortly after a literal load into rd, which
+// is how PIC code turns a pool word into an address.
+static uint32_t xref_pic_value(uint32_t next, uint32_t end, uint32_t rd, uint32_t word) {
+    uint16_t add = 0x4478 | ((rd & 8) << 4) | (rd & 7);
+
+    for (uint32_t i = 0; i < XREF_PIC_WINDOW && next + 2 <= end; i++, next += 2) {
+        if (HW(next) == add)
+            return word + next + 4;
+    }
+
+    return 0;
+}
+
+static int xref_match(xref_query_t* queries, size_t count, uint32_t value,
+                      uint32_t site, uint32_t pool, uint32_t start) {
+    int found = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        xref_query_t* q = &queries[i];
+
+        if (q->ref || q->target != value)
+            continue;
+
+        q->ref = site;
+        q->pool = pool;
+        q->func = xref_func_start(site, start);
+        found++;
+    }
+
+    return found;
+}
+
+// Resolves the first code reference to every target in one pass over
+// [start, end). We decode each halfword as every kind of instruction
+// that can produce an address:
+//
+//   - ldr rX, [pc, #imm]   (16 and 32 bit), pool word == target
+//   - the same, followed by 'add rX, pc' for PIC builds
+//   - adr rX, target       (16 and 32 bit)
+//
+// False positives from decoding data or the second half of a 32-bit
+// instruction are harmless, since they have to produce the exact
+// target to count.
+//
+// Returns the number of targets that were found, or -1 if the batch
+// is too big.
+int xref_resolve(uint32_t start, uint32_t end, xref_query_t* queries, size_t count) {
+    size_t pending = count;
+    int found = 0;
+
+    if (count > XREF_BATCH_MAX)
+        return -1;
+
+    for (size_t i = 0; i < count; i++)
+        queries[i].ref = queries[i].pool = queries[i].func = 0;
+
+    for (uint32_t a = start; pending && a + 4 <= end; a += 2) {
+        uint16_t hw = HW(a);
+        uint16_t hw2 = HW(a + 2);
+        uint32_t pool = 0, rd = 0, next = a + 2, value = 0;
+        bool is_adr = false;
+
+        if ((hw & 0xF800) == 0x4800) {
+            // LDR (literal) T1
+            rd = (hw >> 8) & 7;
+            pool = THUMB_PC(a) + ((hw & 0xFF) << 2);
+        } else if ((hw & 0xFF7F) == 0xF85F && (hw2 >> 12) != 15) {
+            // LDR (literal) T2
+            rd = hw2 >> 12;
+            pool = (hw & 0x80) ? THUMB_PC(a) + (hw2 & 0xFFF)
+                               : THUMB_PC(a) - (hw2 & 0xFFF);
+            next = a + 4;
+        } else if ((hw & 0xF800) == 0xA000) {
+            // ADR T1
+            value = THUMB_PC(a) + ((hw & 0xFF) << 2);
+            is_adr = true;
+        } else if (((hw & 0xFBFF) == 0xF20F || (hw & 0xFBFF) == 0xF2AF) &&
+                   !(hw2 & 0x8000)) {
+            // ADR T2/T3
+            uint32_t imm = ((hw & 0x400) << 1) | ((hw2 & 0x7000) >> 4) | (hw2 & 0xFF);
+            value = (hw & 0xA0) ? THUMB_PC(a) - imm : THUMB_PC(a) + imm;
+            is_adr = true;
+        } else {
+            continue;
+        }
+
+        int n;
+        if (is_adr) {
+            n = xref_match(queries, count, value, a, 0, start);
+        } else {
+            // T2 takes any byte offset, but compilers only ever put
+            // literals on word boundaries, and data that merely looks
+            // like an LDR.W mustn't make us fault on an unaligned load.
+            if (pool < start || pool + 4 > end || (pool & 3))
+                continue;
+
+            uint32_t word = WORD(pool);
+            n = xref_match(queries, count, word, a, pool, start);
+
+            if (!n) {
+                uint32_t pic = xref_pic_value(next, end, rd, word);
+                if (pic)
+                    n = xref_match(queries, count, pic, a, pool, start);
+            }
+        }
+
+        found += n;
+        pending -= n;
+    }
+
+#if KAERU_DEBUG
+    printf("xref_resolve: resolved %d/%u targets\n", found, (unsigned)count);
+#endif
+
+    return found;
+}
+
+// Single target version of xref_resolve() over the whole LK image.
+// Returns the start of the function that references target, or 0.
+uint32_t xref_func_by_addr(uint32_t target) {
+    xref_query_t q = {.target = target};
+
+    xref_resolve(LK_START, LK_END, &q, 1);
+
+#if KAERU_DEBUG
+    printf("xref: 0x%08X used at 0x%08X (func 0x%08X)\n", target, q.ref, q.func);
+#endif
+
+    return q.func;
+}
@@ -7,11 +7,29 @@
 #include <board_ops.h>
 #include <main/main.h>
 
+#include <uart/mtk_uart.h>
+
 void kaeru_late_init(void) {
+    PROFILE_MARK("framebuffer_init");
     OPTIONAL_INIT(framebuffer_init);
+
+    PROFILE_MARK("storage_init");
     OPTIONAL_INIT(storage_init);
+    OPTIONAL_INIT(search_cache_load);
 
+    PROFILE_MARK("board_late_init");
+    patch_begin();
     board_late_init();
+    patch_commit();
+    OPTIONAL_INIT(bl_index_free);
+
+    OPTIONAL_INIT(search_cache_save);
+
+    PROFILE_MARK_LK("app");
+    OPTIONAL_INIT(profiler_publish);
+    OPTIONAL_INIT(trace_init);
+    OPTIONAL_INIT(ramlog_publish);
+    mtk_uart_flush();
 
     ((void (*)(const struct app_descriptor*))(CONFIG_APP_ADDRESS | 1))(NULL);
 }
@@ -26,6 +44,8 @@ void kaeru_late_init(void) {
 // the rodata section of the bootloader to point to our late init
 // function, so that we can take control before mt_boot_init() runs.
 void kaeru_early_init(void) {
+    PROFILE_MARK("kaeru_early_init");
+    OPTIONAL_INIT(ramlog_init);
     OPTIONAL_INIT(sej_init);
 
     uint32_t search_val = CONFIG_APP_ADDRESS | 1;
@@ -34,9 +54,18 @@ void kaeru_early_init(void) {
     uint32_t ptr_addr = 0;
 
     print_kaeru_info(printf);
+    OPTIONAL_INIT(search_cache_init);
+    OPTIONAL_INIT(bl_index_init);
+
+    PROFILE_MARK("common_early_init");
+    patch_begin();
     common_early_init();
+
+    PROFILE_MARK("board_early_init");
     board_early_init();
+    patch_commit();
 
+    PROFILE_MARK("apps_scan");
     for (uint32_t addr = start; addr < end; addr += 4) {
         if (*(volatile uint32_t*)addr == search_val) {
             ptr_addr = addr;
@@ -54,5 +83,7 @@ void kaeru_early_init(void) {
         printf("kaeru won't be able to run its late init!\n");
     }
 
+    PROFILE_MARK_LK("platform_init");
+    mtk_uart_flush();
     ((void (*)(void))(CONFIG_PLATFORM_INIT_ADDRESS | 1))();
 }
\ No newline at end of file
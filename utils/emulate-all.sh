@@ -0,0 +1,68 @@
+#!/bin/bash
+#
+# SPDX-FileCopyrightText: 2026 Roger Ortiz <roger@r0rt1z2.com>
+# SPDX-License-Identifier: AGPL-3.0-or-later
+#
+
+# Builds every defconfig that has an LK image in <images> (named after
+# the codename, i.e. donut.img or donut.bin) and runs it through the
+# emulator, leaving one JSON report per device in <output>. Diffing two
+# output directories shows which devices patch differently.
+#
+# Each device is built out of tree in a temporary directory, so the
+# source tree's own .config and build outputs are left alone.
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+
+if [ $# -lt 1 ] || [ $# -gt 2 ]; then
+    echo "Usage: $0 <images> [output]"
+    exit 1
+fi
+
+IMAGES="$(cd "$1" && pwd)"
+OUTPUT="${2:-emulate-out}"
+FAILED=()
+
+mkdir -p "$OUTPUT"
+OUTPUT="$(cd "$OUTPUT" && pwd)"
+
+BUILD="$(mktemp -d)"
+trap 'rm -rf "$BUILD"' EXIT
+
+cd "$SCRIPT_DIR"
+
+for CONFIG in $(find configs -name "*_defconfig" -type f | sort); do
+    DEVICE="$(basename "$CONFIG" _defconfig)"
+    IMAGE=""
+
+    for EXT in img bin; do
+        if [ -f "$IMAGES/$DEVICE.$EXT" ]; then
+            IMAGE="$IMAGES/$DEVICE.$EXT"
+            break
+        fi
+    done
+
+    [ -z "$IMAGE" ] && continue
+
+    echo "== $DEVICE =="
+
+    OBJ="$BUILD/$DEVICE"
+    mkdir -p "$OBJ"
+    if ! make O="$OBJ" "${DEVICE}_defconfig" >/dev/null ||
+            ! make O="$OBJ" -j"$(nproc)" >/dev/null; then
+        FAILED+=("$DEVICE (build)")
+        continue
+    fi
+
+    if ! python3 utils/emulate.py "$OBJ/.config" "$IMAGE" "$OBJ/kaeru.o" \
+            --json "$OUTPUT/$DEVICE.json" > "$OUTPUT/$DEVICE.log"; then
+        FAILED+=("$DEVICE (emulate)")
+    fi
+done
+
+if [ ${#FAILED[@]} -ne 0 ]; then
+    printf 'Failed: %s\n' "${FAILED[@]}"
+    exit 1
+fi
@@ -0,0 +1,473 @@
+#!/usr/bin/env python3
+#
+# SPDX-FileCopyrightText: 2026 Roger Ortiz <roger@r0rt1z2.com>
+# SPDX-License-Identifier: AGPL-3.0-or-later
+#
+
+"""
+Offline emulator for kaeru board files.
+
+Maps an LK image at CONFIG_BOOTLOADER_BASE, loads a built kaeru.o right
+after it and runs kaeru's early and late init on top, so board patches
+can be checked without flashing anything.
+
+- Calls into LK are stubbed: they return 0 (or whatever --stub says),
+  except for a handful we emulate (malloc, get_env, video_printf...).
+- Unmapped accesses (MMIO) are backed by zeroed pages, except for the
+  UART, whose output is captured.
+- Cache maintenance is skipped.
+
+Every write to LK is reported as (address, old bytes, new bytes), along
+with the time spent in each out-of-line search helper. Inlined searches
+(SEARCH_PATTERN) count towards the board hook that runs them.
+
+Times are host wall-clock under emulation. They are only meaningful
+relative to each other, i.e. when comparing two runs.
+"""
+
+import json
+import struct
+import time
+from argparse import ArgumentParser
+from collections import OrderedDict
+from pathlib import Path
+
+from elftools.elf.elffile import ELFFile
+from elftools.elf.sections import SymbolTableSection
+from unicorn import (
+    UC_ARCH_ARM,
+    UC_HOOK_CODE,
+    UC_HOOK_MEM_UNMAPPED,
+    UC_HOOK_MEM_WRITE,
+    UC_MODE_THUMB,
+    Uc,
+    UcError,
+)
+from unicorn.arm_const import (
+    UC_ARM_REG_LR,
+    UC_ARM_REG_PC,
+    UC_ARM_REG_R0,
+    UC_ARM_REG_R1,
+    UC_ARM_REG_SP,
+)
+
+PAGE = 0x1000
+STACK_SIZE = 0x100000
+HEAP_SIZE = 0x2000000
+
+# Out-of-line helpers worth timing, plus the hooks they're called from.
+TIMED = [
+    'common_early_init',
+    'board_early_init',
+    'board_late_init',
+    'search_patterns',
+    'search_pattern_masked',
+    'search_cache_init',
+    'memmem',
+    'xref_resolve',
+    'bl_index_build',
+]
+
+# Skipped outright, since there's no cache to maintain.
+CACHE_OPS = [
+    'arch_clean_cache_range',
+    'arch_clean_invalidate_cache_range',
+    'arch_invalidate_cache_range',
+    'arch_invalidate_icache',
+]
+
+# CONFIG_*_ADDRESS entries that aren't functions.
+NOT_FUNCTIONS = {
+    'BOOTMODE_ADDRESS',
+    'FRAMEBUFFER_ADDRESS',
+}
+
+
+class DeviceConfig:
+    def __init__(self, path) -> None:
+        self.config = {}
+        with open(path) as f:
+            for line in f:
+                if line.startswith('CONFIG_'):
+                    key, value = line.strip().split('=', 1)
+                    self.config[key] = value
+
+    def get(self, key) -> str:
+        return self.config.get('CONFIG_' + key, None)
+
+
+def to_int(s) -> int:
+    return int(s, 16) if s.startswith('0x') else int(s)
+
+
+def align_down(x, a=PAGE) -> int:
+    return x & ~(a - 1)
+
+
+def align_up(x, a=PAGE) -> int:
+    return (x + a - 1) & ~(a - 1)
+
+
+def load_lk(path) -> bytes:
+    # Prefer liblk so full lk.img files work too, but don't require it
+    # for plain memory dumps.
+    try:
+        from liblk import LkImage
+
+        image = LkImage(path)
+        part = image.partitions.get('lk') or image.partitions.get('LK')
+        if part:
+            return bytes(part.data)
+    except Exception:
+        pass
+
+    return Path(path).read_bytes()
+
+
+class Emulator:
+    def __init__(self, config, lk, elf_path, args) -> None:
+        self.config = config
+        self.args = args
+        self.base = to_int(config.get('BOOTLOADER_BASE'))
+        self.size = to_int(config.get('BOOTLOADER_SIZE'))
+        self.lk_start = align_down(self.base)
+
+        self.uc = Uc(UC_ARCH_ARM, UC_MODE_THUMB)
+        self.writes = []
+        self.timings = OrderedDict((name, []) for name in TIMED)
+        self.lk_calls = OrderedDict()
+        self.mmio = OrderedDict()
+        self.frames = []
+        self.uart = bytearray()
+        self.env = dict(kv.split('=', 1) for kv in args.env)
+        self.stubs = {
+            k: to_int(v) for k, v in (s.split('=', 1) for s in args.stub)
+        }
+
+        self.uart_base = to_int(config.get('UART_BASE') or '0')
+        self.lk_names = self.config_functions()
+
+        self.map_lk(lk)
+        self.load_payload(elf_path)
+        self.map_runtime()
+        self.install_hooks()
+
+    def config_functions(self) -> dict:
+        names = {}
+        for key, value in self.config.config.items():
+            key = key[len('CONFIG_') :]
+            if not key.endswith('_ADDRESS') or key in NOT_FUNCTIONS:
+                continue
+            try:
+                names[to_int(value) & ~1] = key[: -len('_ADDRESS')].lower()
+            except ValueError:
+                continue
+        return names
+
+    def map_lk(self, lk) -> None:
+        lk = lk[: self.size]
+        self.lk_span = align_up(self.base + self.size) - self.lk_start
+        self.uc.mem_map(self.lk_start, self.lk_span)
+        self.uc.mem_write(self.base, lk)
+
+    def load_payload(self, path) -> None:
+        with open(path, 'rb') as f:
+            elf = ELFFile(f)
+            segments = [s for s in elf.iter_segments() if s['p_type'] == 'PT_LOAD']
+            if not segments:
+                exit("ERROR: No loadable segments in '%s'!" % path)
+
+            top = max(s['p_vaddr'] + s['p_memsz'] for s in segments)
+            self.load = self.args.load or align_up(
+                self.lk_start + self.lk_span, 0x10000
+            )
+            self.payload_span = align_up(top)
+            self.uc.mem_map(self.load, self.payload_span)
+
+            for s in segments:
+                self.uc.mem_write(self.load + s['p_vaddr'], s.data())
+
+            self.symbols = {}
+            for section in elf.iter_sections():
+                if not isinstance(section, SymbolTableSection):
+                    continue
+                for sym in section.iter_symbols():
+                    if sym['st_info']['type'] in ('STT_FUNC', 'STT_NOTYPE'):
+                        self.symbols[sym.name] = self.load + (sym['st_value'] & ~1)
+
+        for name in ('main', 'kaeru_late_init'):
+            if name not in self.symbols:
+                exit("ERROR: '%s' not found, is kaeru.o stripped?" % name)
+
+    def map_runtime(self) -> None:
+        self.stack = self.load + self.payload_span + 0x10000
+        self.heap = self.stack + STACK_SIZE
+        self.heap_next = self.heap
+        self.tramp = self.heap + HEAP_SIZE
+
+        self.uc.mem_map(self.stack, STACK_SIZE)
+        self.uc.mem_map(self.heap, HEAP_SIZE)
+        self.uc.mem_map(self.tramp, PAGE)
+
+        # 'bx lr' everywhere, so a stray jump here at least returns.
+        self.uc.mem_write(self.tramp, b'\x70\x47' * (PAGE // 2))
+        self.sentinel = self.tramp + 0x100
+        self.ret_tramp = self.tramp + 0x200
+
+        if self.uart_base:
+            # LSR reads back as all ones, so THRE is always set.
+            self.uc.mem_map(align_down(self.uart_base), PAGE)
+            self.uc.mem_write(align_down(self.uart_base), b'\xff' * PAGE)
+
+    def install_hooks(self) -> None:
+        uc = self.uc
+
+        uc.hook_add(
+            UC_HOOK_MEM_WRITE, self.on_lk_write,
+            begin=self.lk_start, end=self.lk_start + self.lk_span - 1,
+        )
+        uc.hook_add(
+            UC_HOOK_CODE, self.on_lk_call,
+            begin=self.lk_start, end=self.lk_start + self.lk_span - 1,
+        )
+        uc.hook_add(UC_HOOK_MEM_UNMAPPED, self.on_unmapped)
+        uc.hook_add(
+            UC_HOOK_CODE, self.on_return,
+            begin=self.ret_tramp, end=self.ret_tramp,
+        )
+
+        if self.uart_base:
+            uc.hook_add(
+                UC_HOOK_MEM_WRITE, self.on_uart,
+                begin=self.uart_base, end=self.uart_base + 3,
+            )
+
+        for name in CACHE_OPS:
+            addr = self.symbols.get(name)
+            if addr:
+                uc.hook_add(UC_HOOK_CODE, self.on_skip, begin=addr, end=addr)
+
+        for name in TIMED:
+            addr = self.symbols.get(name)
+            if addr:
+                uc.hook_add(
+                    UC_HOOK_CODE, self.on_timed_entry, name, begin=addr, end=addr
+                )
+
+    def read_str(self, addr, limit=256) -> str:
+        if not addr:
+            return ''
+        try:
+            data = bytes(self.uc.mem_read(addr, limit))
+        except UcError:
+            return '<0x%08X>' % addr
+        return data.split(b'\0', 1)[0].decode('utf-8', 'replace')
+
+    def put_str(self, s) -> int:
+        data = s.encode() + b'\0'
+        addr = self.heap_next
+        self.uc.mem_write(addr, data)
+        self.heap_next = align_up(addr + len(data), 8)
+        return addr
+
+    def ret(self, uc, value=0) -> None:
+        uc.reg_write(UC_ARM_REG_R0, value & 0xFFFFFFFF)
+        uc.reg_write(UC_ARM_REG_PC, uc.reg_read(UC_ARM_REG_LR))
+
+    def on_lk_write(self, uc, access, address, size, value, user_data) -> None:
+        old = bytes(uc.mem_read(address, size))
+        new = (value & ((1 << (size * 8)) - 1)).to_bytes(size, 'little')
+        pc = uc.reg_read(UC_ARM_REG_PC)
+
+        last = self.writes[-1] if self.writes else None
+        if last and last['address'] + len(last['new']) == address:
+            last['old'] += old
+            last['new'] += new
+        else:
+            self.writes.append(
+                {'address': address, 'old': old, 'new': new, 'pc': pc}
+            )
+
+    def on_lk_call(self, uc, address, size, user_data) -> None:
+        name = self.lk_names.get(address, 'lk_0x%08X' % address)
+        r0 = uc.reg_read(UC_ARM_REG_R0)
+        r1 = uc.reg_read(UC_ARM_REG_R1)
+        self.lk_calls[name] = self.lk_calls.get(name, 0) + 1
+
+        if name in self.stubs:
+            return self.ret(uc, self.stubs[name])
+
+        if name == 'malloc':
+            addr = self.heap_next
+            if addr + r0 > self.heap + HEAP_SIZE:
+                return self.ret(uc, 0)
+            self.heap_next = align_up(addr + r0, 8)
+            return self.ret(uc, addr)
+
+        if name in ('video_printf', 'dprintf'):
+            print('[%s] %s' % (name, self.read_str(r0).rstrip()))
+        elif name in ('fastboot_register', 'fastboot_publish'):
+            if self.args.verbose:
+                print('[%s] %s' % (name, self.read_str(r0)))
+        elif name == 'get_env':
+            key = self.read_str(r0)
+            if key in self.env:
+                return self.ret(uc, self.put_str(self.env[key]))
+        elif name == 'set_env':
+            self.env[self.read_str(r0)] = self.read_str(r1)
+
+        self.ret(uc, 0)
+
+    def on_skip(self, uc, address, size, user_data) -> None:
+        self.ret(uc, 0)
+
+    def on_unmapped(self, uc, access, address, size, value, user_data) -> bool:
+        page = align_down(address)
+        self.mmio[page] = self.mmio.get(page, 0) + 1
+        uc.mem_map(page, PAGE)
+        return True
+
+    def on_uart(self, uc, access, address, size, value, user_data) -> None:
+        if address == self.uart_base:
+            self.uart.append(value & 0xFF)
+
+    def on_timed_entry(self, uc, address, size, name) -> None:
+        lr = uc.reg_read(UC_ARM_REG_LR)
+        self.frames.append((name, lr, lr & ~1, time.perf_counter()))
+        uc.reg_write(UC_ARM_REG_LR, self.ret_tramp | 1)
+
+    def on_return(self, uc, address, size, user_data) -> None:
+        name, lr, caller, start = self.frames.pop()
+        self.timings[name].append(
+            {'caller': (caller - 4) & 0xFFFFFFFF, 'seconds': time.perf_counter() - start}
+        )
+        uc.reg_write(UC_ARM_REG_PC, lr)
+
+    def call(self, addr) -> None:
+        self.uc.reg_write(UC_ARM_REG_SP, self.stack + STACK_SIZE - 0x100)
+        self.uc.reg_write(UC_ARM_REG_LR, self.sentinel | 1)
+        self.uc.emu_start(
+            addr | 1, self.sentinel, timeout=int(self.args.timeout * 1000000)
+        )
+
+        if self.uc.reg_read(UC_ARM_REG_PC) != self.sentinel:
+            print(
+                'Warning: stopped at 0x%08X before returning (timeout?)'
+                % self.uc.reg_read(UC_ARM_REG_PC)
+            )
+
+    def run(self) -> None:
+        for stage, sym in (('early', 'main'), ('late', 'kaeru_late_init')):
+            print('Running %s init from 0x%08X' % (stage, self.symbols[sym]))
+            try:
+                self.call(self.symbols[sym])
+            except UcError as e:
+                pc = self.uc.reg_read(UC_ARM_REG_PC)
+                print('ERROR: %s init faulted at 0x%08X: %s' % (stage, pc, e))
+                self.frames.clear()
+                break
+            self.frames.clear()
+
+    def report(self) -> None:
+        if self.uart and self.args.verbose:
+            print('\n== UART ==')
+            print(self.uart.decode('utf-8', 'replace').replace('\r', ''))
+
+        print('\n== Writes to LK (%d) ==' % len(self.writes))
+        for w in self.writes:
+            print(
+                '  0x%08X  %s -> %s  (pc 0x%08X)'
+                % (w['address'], w['old'].hex(' '), w['new'].hex(' '), w['pc'])
+            )
+
+        print('\n== Time spent ==')
+        for name, calls in self.timings.items():
+            if not calls:
+                continue
+            total = sum(c['seconds'] for c in calls) * 1000
+            worst = max(calls, key=lambda c: c['seconds'])
+            print(
+                '  %-24s calls=%-4d total=%9.2f ms  max=%8.2f ms (from 0x%08X)'
+                % (name, len(calls), total, worst['seconds'] * 1000, worst['caller'])
+            )
+
+        if self.lk_calls:
+            print('\n== Calls into LK ==')
+            for name, count in self.lk_calls.items():
+                print('  %-32s x%d' % (name, count))
+
+        if self.mmio:
+            print('\n== Unmapped pages touched ==')
+            for page, count in self.mmio.items():
+                print('  0x%08X x%d' % (page, count))
+
+    def dump_json(self, path) -> None:
+        out = {
+            'writes': [
+                {
+                    'address': '0x%08X' % w['address'],
+                    'old': w['old'].hex(),
+                    'new': w['new'].hex(),
+                }
+                for w in self.writes
+            ],
+            'timings': {
+                name: [c['seconds'] for c in calls]
+                for name, calls in self.timings.items()
+                if calls
+            },
+            'lk_calls': self.lk_calls,
+        }
+        with open(path, 'w') as f:
+            json.dump(out, f, indent=2)
+
+
+def main() -> None:
+    parser = ArgumentParser(
+        description='Run a kaeru build against an LK image on the host'
+    )
+
+    parser.add_argument('config', help='Path to the device configuration file')
+    parser.add_argument('input', help='Path to the LK image or memory dump')
+    parser.add_argument('payload', help='Path to the kaeru.o ELF to run')
+    parser.add_argument(
+        '--load', type=lambda s: int(s, 0), default=0,
+        help='Address to load kaeru at (defaults to right after LK)',
+    )
+    parser.add_argument(
+        '--stub', action='append', default=[], metavar='NAME=VALUE',
+        help='Return VALUE from the LK function NAME (i.e. get_sboot_state=1)',
+    )
+    parser.add_argument(
+        '--env', action='append', default=[], metavar='KEY=VALUE',
+        help='Make get_env() return VALUE for KEY',
+    )
+    parser.add_argument(
+        '--timeout', type=float, default=60.0,
+        help='Seconds to let each init stage run for',
+    )
+    parser.add_argument('--json', help='Also write the results to this file')
+    parser.add_argument('-v', '--verbose', action='store_true')
+
+    args = parser.parse_args()
+
+    for path in (args.config, args.input, args.payload):
+        if not Path(path).is_file():
+            exit("ERROR: File not found: '%s'!" % path)
+
+    config = DeviceConfig(args.config)
+    if not config.get('BOOTLOADER_BASE') or not config.get('BOOTLOADER_SIZE'):
+        exit('ERROR: Invalid basic required configuration!')
+
+    emu = Emulator(config, load_lk(args.input), args.payload, args)
+    print('LK mapped at 0x%08X, kaeru loaded at 0x%08X' % (emu.lk_start, emu.load))
+
+    emu.run()
+    emu.report()
+
+    if args.json:
+        emu.dump_json(args.json)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,119 @@
+#!/usr/bin/env python3
+#
+# SPDX-FileCopyrightText: 2026 Roger Ortiz <roger@r0rt1z2.com>
+# SPDX-License-Identifier: AGPL-3.0-or-later
+#
+
+"""
+Measures full-screen framebuffer fills on the host.
+
+Runs fb_clear() and fb_fill_rect() from a built kaeru.o under unicorn
+on a 1080x2400 screen (or --width/--height), in whatever pixel format
+and stride alignment the .config selects, and reports how many
+instructions each one needs per pixel. Like utils/libctest.py --bench,
+that count can be compared between builds where emulated wall-clock
+time can't, i.e.:
+
+  make fbbench
+  make fbbench FBBENCH_FLAGS='--width 720 --height 1600'
+
+Every fill is checked afterwards: the rectangle has to hold a single
+pixel value, and what is around it has to be left alone. Drawing is
+done unrotated, in the panel's own orientation.
+"""
+
+import time
+from argparse import ArgumentParser
+from pathlib import Path
+
+from emulate import DeviceConfig, to_int
+from libctest import DATA, Runner
+
+ROUTINES = ['fb_init', 'fb_set_rotation', 'fb_clear', 'fb_fill_rect']
+
+BACKGROUND = 0xFF102030
+COLOR = 0xFF336699
+
+
+def check(run, stride, bpp, rect, screen) -> bool:
+    x, y, w, h = rect
+    width, height = screen
+    px = run.read(y * stride + x * bpp, bpp)
+
+    for row in range(y, y + h):
+        if run.read(row * stride + x * bpp, w * bpp) != px * w:
+            return False
+
+    # One pixel on each side of the rectangle, where there is one.
+    around = [(x - 1, y), (x + w, y), (x, y - 1), (x, y + h)]
+    for ax, ay in around:
+        if 0 <= ax < width and 0 <= ay < height:
+            if run.read(ay * stride + ax * bpp, bpp) == px:
+                return False
+
+    return True
+
+
+def main() -> None:
+    parser = ArgumentParser(description='Measure framebuffer fills of a kaeru build')
+    parser.add_argument('config', help='Path to the .config kaeru.o was built with')
+    parser.add_argument('payload', help='Path to the kaeru.o ELF to measure')
+    parser.add_argument('--width', type=int, default=1080,
+                        help='Screen width in pixels (default: 1080)')
+    parser.add_argument('--height', type=int, default=2400,
+                        help='Screen height in pixels (default: 2400)')
+    args = parser.parse_args()
+
+    for path in (args.config, args.payload):
+        if not Path(path).is_file():
+            exit("ERROR: File not found: '%s'!" % path)
+
+    config = DeviceConfig(args.config)
+    if config.get('FRAMEBUFFER_SUPPORT') != 'y':
+        exit('ERROR: kaeru.o was built without CONFIG_FRAMEBUFFER_SUPPORT!')
+
+    bpp = to_int(config.get('FRAMEBUFFER_BYTES_PER_PIXEL') or '4')
+    alignment = to_int(config.get('FRAMEBUFFER_ALIGNMENT') or '64')
+    width, height = args.width, args.height
+    stride = (width * bpp + alignment - 1) & ~(alignment - 1)
+
+    run = Runner(args.payload, ROUTINES, stride * height)
+    run.call('fb_init', DATA, width, height, bpp, alignment)
+    run.call('fb_set_rotation', 0)
+    run.count_instructions()
+
+    # Full screen through both entry points, then the same with ragged
+    # edges, then a single column, where per-row overhead is all there
+    # is.
+    cases = [
+        ('clear', None, (0, 0, width, height)),
+        ('fill full screen', (0, 0, width, height), (0, 0, width, height)),
+        ('fill inset by 1', (1, 1, width - 3, height - 2), (1, 1, width - 3, height - 2)),
+        ('fill one column', (width // 2, 0, 1, height), (width // 2, 0, 1, height)),
+    ]
+
+    print('%ux%u, %u bytes per pixel, stride %u' % (width, height, bpp, stride))
+    failures = 0
+
+    for label, rect, covered in cases:
+        run.call('fb_clear', BACKGROUND)
+
+        start = time.perf_counter()
+        if rect is None:
+            run.call('fb_clear', COLOR)
+        else:
+            run.call('fb_fill_rect', *rect, COLOR)
+        elapsed = time.perf_counter() - start
+
+        ok = check(run, stride, bpp, covered, (width, height))
+        area = covered[2] * covered[3]
+        print('  %-18s %6.3f instructions/pixel  %9.2f ms  %s'
+              % (label, run.count / area, elapsed * 1000, 'OK' if ok else 'FAIL'))
+        failures += not ok
+
+    if failures:
+        exit(1)
+
+
+if __name__ == '__main__':
+    main()
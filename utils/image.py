@@ -0,0 +1,166 @@
+#!/usr/bin/env python3
+#
+# SPDX-FileCopyrightText: 2026 Roger Ortiz <roger@r0rt1z2.com>
+# SPDX-License-Identifier: AGPL-3.0-or-later
+#
+
+# Converts an image into the palette + RLE format drawn by fb_blit_rle()
+# and writes it out as a C file, ready to be built into a board:
+#
+#   ./utils/image.py logo.png board/vendor/logo.c --name logo
+#
+# Any format Pillow can read works. Pixels that are mostly transparent
+# become a transparent palette entry, everything else is reduced to at
+# most 256 opaque colours.
+
+import re
+from argparse import ArgumentParser
+from pathlib import Path
+
+from PIL import Image
+
+MAX_RUN = 128
+LITERAL = 0x80
+TRANSPARENT = 0x00000000
+
+
+def quantize(image: Image.Image, colors: int) -> tuple[list[int], list[int]]:
+    rgba = image.convert('RGBA')
+    mask = [a >= 128 for a in rgba.getchannel('A').tobytes()]
+    has_alpha = not all(mask)
+
+    # Leave room for the transparent entry if we need one.
+    rgb = rgba.convert('RGB')
+    if rgb.getcolors(colors - has_alpha) is None:
+        rgb = rgb.quantize(colors - has_alpha, dither=Image.Dither.NONE).convert('RGB')
+
+    palette = [TRANSPARENT] if has_alpha else []
+    lookup = {}
+    pixels = []
+
+    raw = rgb.tobytes()
+    for opaque, r, g, b in zip(mask, raw[0::3], raw[1::3], raw[2::3]):
+        if not opaque:
+            pixels.append(0)
+            continue
+
+        color = 0xFF000000 | (r << 16) | (g << 8) | b
+        if color not in lookup:
+            lookup[color] = len(palette)
+            palette.append(color)
+        pixels.append(lookup[color])
+
+    return palette, pixels
+
+
+def run_length(row: list[int], i: int) -> int:
+    n = 1
+    while i + n < len(row) and n < MAX_RUN and row[i + n] == row[i]:
+        n += 1
+    return n
+
+
+def encode_row(row: list[int]) -> bytearray:
+    out = bytearray()
+    literal = []
+
+    def flush() -> None:
+        if literal:
+            out.append(LITERAL | (len(literal) - 1))
+            out.extend(literal)
+            literal.clear()
+
+    i = 0
+    while i < len(row):
+        n = run_length(row, i)
+
+        # A run of two only pays off if it doesn't split a literal.
+        if n >= 3 or (n == 2 and not literal):
+            flush()
+            out += bytes((n - 1, row[i]))
+            i += n
+            continue
+
+        literal.append(row[i])
+        i += 1
+        if len(literal) == MAX_RUN:
+            flush()
+
+    flush()
+    return out
+
+
+def encode(width: int, height: int, pixels: list[int]) -> bytearray:
+    data = bytearray()
+    for y in range(height):
+        data += encode_row(pixels[y * width : (y + 1) * width])
+    return data
+
+
+def c_array(values, per_line: int, fmt: str) -> str:
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append('    ' + ', '.join(fmt % v for v in values[i : i + per_line]) + ',')
+    return '\n'.join(lines)
+
+
+def write_c(path: Path, name: str, source: str, width: int, height: int,
+            palette: list[int], data: bytearray) -> None:
+    path.write_text(
+        '//\n'
+        f'// Generated by utils/image.py from {source}, do not edit.\n'
+        '//\n'
+        '\n'
+        '#include <lib/framebuffer.h>\n'
+        '\n'
+        f'static const uint32_t {name}_palette[] = {{\n'
+        f'{c_array(palette, 6, "0x%08X")}\n'
+        '};\n'
+        '\n'
+        f'static const uint8_t {name}_data[] = {{\n'
+        f'{c_array(data, 12, "0x%02X")}\n'
+        '};\n'
+        '\n'
+        f'const fb_image_t {name} = {{\n'
+        f'    .width = {width},\n'
+        f'    .height = {height},\n'
+        f'    .colors = {len(palette)},\n'
+        f'    .palette = {name}_palette,\n'
+        f'    .data = {name}_data,\n'
+        f'    .size = sizeof({name}_data),\n'
+        '};\n'
+    )
+
+
+def main() -> None:
+    parser = ArgumentParser(description='Convert an image for fb_blit_rle()')
+    parser.add_argument('input', type=Path, help='Image to convert')
+    parser.add_argument('output', type=Path, help='C file to write')
+    parser.add_argument('--name', help='Symbol name (default: output file name)')
+    parser.add_argument('--colors', type=int, default=256,
+                        help='Palette size limit, 2 to 256 (default: 256)')
+    args = parser.parse_args()
+
+    name = args.name or re.sub(r'\W', '_', args.output.stem)
+    if not re.fullmatch(r'[A-Za-z_]\w*', name):
+        exit(f'ERROR: {name!r} is not a valid C identifier')
+
+    if not 2 <= args.colors <= 256:
+        exit('ERROR: --colors must be between 2 and 256')
+
+    image = Image.open(args.input)
+    width, height = image.size
+    if width > 0xFFFF or height > 0xFFFF:
+        exit(f'ERROR: {width}x{height} is too big')
+
+    palette, pixels = quantize(image, args.colors)
+    data = encode(width, height, pixels)
+    write_c(args.output, name, args.input.name, width, height, palette, data)
+
+    raw = width * height * 4
+    print(f'{args.input.name}: {width}x{height}, {len(palette)} colours, '
+          f'{len(data) + len(palette) * 4} bytes ({raw} uncompressed)')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,271 @@
+#!/usr/bin/env python3
+#
+# SPDX-FileCopyrightText: 2026 Roger Ortiz <roger@r0rt1z2.com>
+# SPDX-License-Identifier: AGPL-3.0-or-later
+#
+
+"""
+Checks kaeru's assembly string routines on the host.
+
+Runs memmove, memcmp and strlen from a built kaeru.o under unicorn,
+over every length, alignment and overlap that can take a different
+path through them, and compares the results with Python's. Each
+memmove also checks that nothing around the destination was touched.
+
+With --bench, also reports how many instructions each routine needs
+per byte on large buffers, which unlike emulated wall-clock time can
+be compared between builds.
+"""
+
+import random
+from argparse import ArgumentParser
+from pathlib import Path
+
+from elftools.elf.elffile import ELFFile
+from elftools.elf.sections import SymbolTableSection
+from unicorn import UC_ARCH_ARM, UC_HOOK_CODE, UC_MODE_THUMB, Uc
+from unicorn.arm_const import (
+    UC_ARM_REG_LR,
+    UC_ARM_REG_R0,
+    UC_ARM_REG_R1,
+    UC_ARM_REG_R2,
+    UC_ARM_REG_R3,
+    UC_ARM_REG_SP,
+)
+
+CODE = 0x10000000
+DATA = 0x20000000
+STACK = 0x30000000
+SENTINEL = 0x40000000
+
+PAGE = 0x1000
+DATA_SIZE = 0x40000
+STACK_SIZE = 0x10000
+
+# Past the point where every routine has switched to its widest loop.
+LENGTHS = list(range(0, 80)) + [127, 128, 129, 255, 256, 1023, 1024]
+
+# memmove distances from source to destination. Small ones overlap
+# within a single block, large ones don't overlap at all.
+DISTANCES = [-2048, -64, -17, -16, -15, -5, -4, -3, -1,
+             0, 1, 3, 4, 5, 15, 16, 17, 64, 2048]
+
+ROUTINES = ['__memmove_arm', '__memcmp_arm', '__strlen_arm']
+
+
+def to_signed(value) -> int:
+    return value - (1 << 32) if value & 0x80000000 else value
+
+
+# Loads kaeru.o and calls its functions on buffers in DATA. Also used
+# by utils/memmembench.py and utils/fbbench.py.
+class Runner:
+    def __init__(self, path, routines=ROUTINES, data_size=DATA_SIZE) -> None:
+        self.uc = Uc(UC_ARCH_ARM, UC_MODE_THUMB)
+        self.symbols = {}
+        self.count = 0
+
+        with open(path, 'rb') as f:
+            elf = ELFFile(f)
+            segments = [s for s in elf.iter_segments() if s['p_type'] == 'PT_LOAD']
+            if not segments:
+                exit("ERROR: No loadable segments in '%s'!" % path)
+
+            top = max(s['p_vaddr'] + s['p_memsz'] for s in segments)
+            self.uc.mem_map(CODE, (top + PAGE - 1) & ~(PAGE - 1))
+            for s in segments:
+                self.uc.mem_write(CODE + s['p_vaddr'], s.data())
+
+            for section in elf.iter_sections():
+                if isinstance(section, SymbolTableSection):
+                    for sym in section.iter_symbols():
+                        self.symbols[sym.name] = CODE + (sym['st_value'] & ~1)
+
+        for name in routines:
+            if name not in self.symbols:
+                exit("ERROR: '%s' not found, is kaeru.o stripped?" % name)
+
+        self.relocate()
+
+        self.uc.mem_map(DATA, (data_size + PAGE - 1) & ~(PAGE - 1))
+        self.uc.mem_map(STACK, STACK_SIZE)
+        self.uc.mem_map(SENTINEL, PAGE)
+
+    # What main/start.S does on the device. Only code that reaches
+    # globals through the GOT needs it, the string routines don't.
+    def relocate(self) -> None:
+        start = self.symbols.get('__got_start')
+        end = self.symbols.get('__got_end')
+        if start is None or end is None:
+            return
+
+        for addr in range(start, end, 4):
+            value = int.from_bytes(self.uc.mem_read(addr, 4), 'little')
+            if value:
+                self.uc.mem_write(addr, ((value + CODE) & 0xFFFFFFFF).to_bytes(4, 'little'))
+
+    # Only for --bench, since it slows every instruction down.
+    def count_instructions(self) -> None:
+        self.uc.hook_add(UC_HOOK_CODE, self.on_code)
+
+    def on_code(self, uc, address, size, user_data) -> None:
+        self.count += 1
+
+    def call(self, name, *args) -> int:
+        regs = (UC_ARM_REG_R0, UC_ARM_REG_R1, UC_ARM_REG_R2, UC_ARM_REG_R3)
+        for reg, value in zip(regs, args):
+            self.uc.reg_write(reg, value & 0xFFFFFFFF)
+
+        # Anything past r3 goes on the stack, which has to stay 8-byte
+        # aligned at the call.
+        sp = STACK + STACK_SIZE - ((len(args[4:]) * 4 + 7) & ~7)
+        for i, value in enumerate(args[4:]):
+            self.uc.mem_write(sp + i * 4, (value & 0xFFFFFFFF).to_bytes(4, 'little'))
+
+        self.uc.reg_write(UC_ARM_REG_SP, sp)
+        self.uc.reg_write(UC_ARM_REG_LR, SENTINEL | 1)
+        self.count = 0
+        self.uc.emu_start(self.symbols[name] | 1, SENTINEL)
+        return self.uc.reg_read(UC_ARM_REG_R0)
+
+    def write(self, offset, data) -> None:
+        self.uc.mem_write(DATA + offset, bytes(data))
+
+    def read(self, offset, size) -> bytes:
+        return bytes(self.uc.mem_read(DATA + offset, size))
+
+
+def test_memmove(run, rng) -> int:
+    failures = 0
+    span = 3 * 4096
+    base = bytes(rng.getrandbits(8) for _ in range(span))
+
+    for length in LENGTHS:
+        for align in range(4):
+            for distance in DISTANCES:
+                src = 4096 + align
+                dst = src + distance
+
+                run.write(0, base)
+                expected = bytearray(base)
+                expected[dst : dst + length] = base[src : src + length]
+
+                ret = run.call('__memmove_arm', DATA + dst, DATA + src, length)
+                if ret != DATA + dst or run.read(0, span) != expected:
+                    print('memmove: length %d, src align %d, dst %+d: FAIL'
+                          % (length, align, distance))
+                    failures += 1
+
+    return failures
+
+
+def test_memcmp(run, rng) -> int:
+    failures = 0
+
+    for length in LENGTHS:
+        positions = sorted({0, length // 2, length - 1} | set(range(min(length, 20))))
+        for a1 in range(4):
+            for a2 in range(4):
+                s1, s2 = 64 + a1, 8192 + a2
+                data = bytes(rng.getrandbits(8) for _ in range(length))
+
+                # Equal, then differing at each position in both
+                # directions, including across the sign bit.
+                cases = [(None, 0)] + [
+                    (pos, delta) for pos in positions if 0 <= pos < length
+                    for delta in (1, -1, 0x80)
+                ]
+
+                for pos, delta in cases:
+                    other = bytearray(data)
+                    if pos is not None:
+                        other[pos] = (other[pos] + delta) & 0xFF
+
+                    run.write(s1, data)
+                    run.write(s2, other)
+                    ret = to_signed(run.call('__memcmp_arm', DATA + s1, DATA + s2, length))
+                    want = (data > bytes(other)) - (data < bytes(other))
+
+                    if (ret > 0) - (ret < 0) != want:
+                        print('memcmp: length %d, align %d/%d, diff at %s: FAIL'
+                              % (length, a1, a2, pos))
+                        failures += 1
+
+    return failures
+
+
+def test_strlen(run, rng) -> int:
+    failures = 0
+
+    for length in LENGTHS:
+        for align in range(8):
+            # Bytes that trip up a sloppy zero-byte check.
+            for fill in (0x01, 0x80, 0xFF, None):
+                s = 64 + align
+                text = bytes(fill or rng.randint(1, 255) for _ in range(length))
+                tail = bytes(rng.choice((0, 1, 0x80, 0xFF)) for _ in range(7))
+
+                run.write(s, text + b'\0' + tail)
+                ret = run.call('__strlen_arm', DATA + s)
+
+                if ret != length:
+                    print('strlen: length %d, align %d: got %d, FAIL'
+                          % (length, align, ret))
+                    failures += 1
+
+    return failures
+
+
+def bench(run) -> None:
+    size = 64 * 1024 - 1024
+
+    run.count_instructions()
+    run.write(0, bytes(size // 2 + 16))
+    run.write(size // 2 + 16, bytes(size // 2))
+    cases = [
+        ('memmove forward', '__memmove_arm', (DATA, DATA + size // 2, size // 2)),
+        ('memmove backward', '__memmove_arm', (DATA + 16, DATA, size // 2)),
+        ('memcmp equal', '__memcmp_arm', (DATA, DATA + size // 2, size // 2)),
+    ]
+
+    for label, name, args in cases:
+        run.call(name, *args)
+        print('  %-18s %6.3f instructions/byte' % (label, run.count / args[2]))
+
+    run.write(0, b'\x55' * (size // 2) + b'\0')
+    run.call('__strlen_arm', DATA)
+    print('  %-18s %6.3f instructions/byte' % ('strlen', run.count / (size // 2)))
+
+
+def main() -> None:
+    parser = ArgumentParser(description="Check kaeru's assembly string routines")
+    parser.add_argument('payload', help='Path to the kaeru.o ELF to test')
+    parser.add_argument('--bench', action='store_true',
+                        help='Also report instructions per byte on large buffers')
+    parser.add_argument('--seed', type=int, default=0,
+                        help='Seed for the random test data (default: 0)')
+    args = parser.parse_args()
+
+    if not Path(args.payload).is_file():
+        exit("ERROR: File not found: '%s'!" % args.payload)
+
+    run = Runner(args.payload)
+    rng = random.Random(args.seed)
+    failures = 0
+
+    for name, test in (('memmove', test_memmove), ('memcmp', test_memcmp),
+                       ('strlen', test_strlen)):
+        failed = test(run, rng)
+        print('%-8s %s' % (name, 'FAIL (%d)' % failed if failed else 'OK'))
+        failures += failed
+
+    if args.bench:
+        print('\n== Throughput ==')
+        bench(run)
+
+    if failures:
+        exit(1)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,119 @@
+#!/usr/bin/env python3
+#
+# SPDX-FileCopyrightText: 2026 Roger Ortiz <roger@r0rt1z2.com>
+# SPDX-License-Identifier: AGPL-3.0-or-later
+#
+
+"""
+Compares memmem() implementations on a real LK image.
+
+Runs memmem from each given kaeru.o under unicorn over a dump of LK,
+the same haystack SEARCH_STRING and XREF_FUNC_BY_STRING walk on the
+device. Build kaeru once per CONFIG_MEMMEM_* choice, i.e.:
+
+  make O=out/swar <device>_defconfig && make O=out/swar
+  make O=out/bytewise <device>_defconfig && make O=out/bytewise menuconfig
+  make O=out/bytewise
+  ./utils/memmembench.py lk.img out/swar/kaeru.o out/bytewise/kaeru.o
+
+The needles are the string literals board files search for, pieces
+of the image itself, and copies of those with the last byte changed,
+which usually aren't there and so cost a full scan. Every result is
+checked against Python's bytes.find().
+
+Times are host wall-clock under emulation. They are only meaningful
+relative to each other, i.e. between the builds of one run.
+"""
+
+import ast
+import random
+import re
+import time
+from argparse import ArgumentParser
+from pathlib import Path
+
+from emulate import load_lk
+from libctest import DATA, Runner
+
+NEEDLE_MACROS = re.compile(r'(?:SEARCH_STRING|XREF_FUNC_BY_STRING)\(\s*("(?:[^"\\]|\\.)*")')
+
+# Lengths on both sides of where the SWAR variant hands over to
+# two-way (32 bytes).
+PIECE_LENGTHS = [2, 3, 4, 8, 16, 31, 32, 64]
+
+
+def board_needles(root) -> list:
+    needles = set()
+    for path in sorted(root.glob('board/**/*.c')):
+        for literal in NEEDLE_MACROS.findall(path.read_text(errors='replace')):
+            try:
+                needles.add(ast.literal_eval(literal).encode('latin-1'))
+            except (ValueError, SyntaxError, UnicodeEncodeError):
+                continue
+    return sorted(needles)
+
+
+def image_needles(lk, rng) -> list:
+    needles = []
+    for length in PIECE_LENGTHS:
+        for _ in range(4):
+            at = rng.randrange(len(lk) - length)
+            piece = lk[at : at + length]
+            needles.append(piece)
+            needles.append(piece[:-1] + bytes([piece[-1] ^ 0xFF]))
+    return needles
+
+
+def main() -> None:
+    parser = ArgumentParser(description='Compare memmem() builds on an LK image')
+    parser.add_argument('input', help='Path to the LK image or memory dump')
+    parser.add_argument('payloads', nargs='+', help='kaeru.o builds to compare')
+    parser.add_argument('--seed', type=int, default=0,
+                        help='Seed for picking needles from the image (default: 0)')
+    args = parser.parse_args()
+
+    for path in [args.input] + args.payloads:
+        if not Path(path).is_file():
+            exit("ERROR: File not found: '%s'!" % path)
+
+    lk = load_lk(args.input)
+    rng = random.Random(args.seed)
+    root = Path(__file__).resolve().parent.parent
+    needles = board_needles(root) + image_needles(lk, rng)
+    needle_at = DATA + len(lk) + 16
+
+    totals = []
+    failures = 0
+
+    for payload in args.payloads:
+        run = Runner(payload, ['memmem'], len(lk) + 0x1000)
+        run.write(0, lk)
+        total = 0.0
+
+        for needle in needles:
+            run.write(len(lk) + 16, needle)
+
+            start = time.perf_counter()
+            ret = run.call('memmem', DATA, len(lk), needle_at, len(needle))
+            total += time.perf_counter() - start
+
+            want = lk.find(needle)
+            got = ret - DATA if ret else -1
+            if got != want:
+                print('%s: %r found at %d instead of %d'
+                      % (payload, needle, got, want))
+                failures += 1
+
+        totals.append(total)
+
+    print('%d needles over %d bytes of LK' % (len(needles), len(lk)))
+    for payload, total in zip(args.payloads, totals):
+        print('  %-40s %9.2f ms  (x%.2f)'
+              % (payload, total * 1000, total / totals[0]))
+
+    if failures:
+        exit(1)
+
+
+if __name__ == '__main__':
+    main()
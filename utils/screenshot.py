@@ -0,0 +1,138 @@
+#!/usr/bin/env python3
+#
+# SPDX-FileCopyrightText: 2026 Roger Ortiz <roger@r0rt1z2.com>
+# SPDX-License-Identifier: AGPL-3.0-or-later
+#
+
+# Captures what kaeru is showing through 'fastboot oem screenshot' and
+# saves it as a PNG, rotated the way it appears on the device:
+#
+#   ./utils/screenshot.py screen.png
+#
+# The output of an earlier 'fastboot oem screenshot 2> log.txt' can be
+# decoded with --input log.txt instead. See lib/framebuffer/screenshot.c
+# for the format.
+
+import base64
+import subprocess
+import zlib
+from argparse import ArgumentParser
+from pathlib import Path
+
+from PIL import Image
+
+PREFIX = '(bootloader) '
+
+COPY, RUN, LITERAL = 0, 1, 2
+
+# Bytes per pixel, and the Pillow raw mode that reads them as RGB.
+FORMATS = {
+    'argb8888': (4, 'BGRX'),
+    'abgr8888': (4, 'RGBX'),
+    'rgb888': (3, 'BGR'),
+    'rgb565': (2, 'BGR;16'),
+}
+
+
+def capture(fastboot: str) -> str:
+    result = subprocess.run(
+        [fastboot, 'oem', 'screenshot'], capture_output=True, text=True
+    )
+    if result.returncode:
+        exit(f'ERROR: fastboot failed:\n{result.stderr.strip()}')
+    return result.stderr
+
+
+def parse(log: str) -> tuple[list[str], bytes, int, int]:
+    header, data, end = None, bytearray(), None
+
+    for line in log.splitlines():
+        if not line.startswith(PREFIX):
+            continue
+
+        text = line[len(PREFIX) :].strip()
+        if text.startswith('screenshot '):
+            header, data = text.split()[1:], bytearray()
+        elif text.startswith('end '):
+            end = text.split()[1:]
+        elif header is not None:
+            data += base64.b64decode(text)
+
+    if header is None or end is None:
+        exit('ERROR: no complete screenshot in the fastboot output')
+
+    return header, bytes(data), int(end[0]), int(end[1], 16)
+
+
+def decode(data: bytes, width: int, height: int, bpp: int) -> bytearray:
+    out = bytearray(width * height * bpp)
+    stride = width * bpp
+    pos = 0
+
+    for y in range(height):
+        row = y * stride
+        x = 0
+
+        while x < width:
+            header = data[pos]
+            kind, length = header >> 6, header & 0x3F
+            pos += 1
+            if not length:
+                length = data[pos] | data[pos + 1] << 8
+                pos += 2
+
+            start, end = row + x * bpp, row + (x + length) * bpp
+            if x + length > width:
+                exit(f'ERROR: packet runs past the end of row {y}')
+
+            if kind == COPY:
+                out[start:end] = out[start - stride : end - stride]
+            elif kind == RUN:
+                out[start:end] = data[pos : pos + bpp] * length
+                pos += bpp
+            elif kind == LITERAL:
+                out[start:end] = data[pos : pos + length * bpp]
+                pos += length * bpp
+            else:
+                exit(f'ERROR: bad packet 0x{header:02X} in row {y}')
+
+            x += length
+
+    return out
+
+
+def main() -> None:
+    parser = ArgumentParser(description='Save a kaeru screenshot as PNG')
+    parser.add_argument('output', type=Path, help='PNG file to write')
+    parser.add_argument('--input', type=Path,
+                        help='Saved fastboot output to decode instead')
+    parser.add_argument('--fastboot', default='fastboot',
+                        help='fastboot binary to use (default: fastboot)')
+    parser.add_argument('--no-rotate', action='store_true',
+                        help="Keep the panel's own orientation")
+    args = parser.parse_args()
+
+    log = args.input.read_text() if args.input else capture(args.fastboot)
+    header, data, size, checksum = parse(log)
+    width, height, fmt, rotation = int(header[0]), int(header[1]), header[2], int(header[3])
+
+    if fmt not in FORMATS:
+        exit(f'ERROR: unknown pixel format {fmt}')
+    if len(data) != size or zlib.adler32(data) != checksum:
+        exit('ERROR: screenshot data is incomplete or corrupted')
+
+    bpp, rawmode = FORMATS[fmt]
+    pixels = decode(data, width, height, bpp)
+    image = Image.frombytes('RGB', (width, height), bytes(pixels), 'raw', rawmode)
+
+    # The panel shows the drawing turned clockwise, turn it back.
+    if rotation and not args.no_rotate:
+        image = image.rotate(rotation, expand=True)
+
+    image.save(args.output)
+    print(f'{args.output}: {image.width}x{image.height}, '
+          f'{size} bytes for a {width * height * bpp} byte frame')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,147 @@
+#!/usr/bin/env python3
+#
+# SPDX-FileCopyrightText: 2026 Roger Ortiz <roger@r0rt1z2.com>
+# SPDX-License-Identifier: AGPL-3.0-or-later
+#
+
+# Reads kaeru's binary trace through 'fastboot oem trace' and prints it
+# as text, using the format strings that only exist in kaeru.o:
+#
+#   ./utils/trace.py kaeru.o
+#
+# kaeru.o has to come from the same build that is running on the
+# device. The output of an earlier 'fastboot oem trace 2> log.txt' can
+# be decoded with --input log.txt instead.
+
+import base64
+import re
+import struct
+import subprocess
+from argparse import ArgumentParser
+from pathlib import Path
+
+from elftools.elf.constants import SH_FLAGS
+from elftools.elf.elffile import ELFFile
+
+PREFIX = '(bootloader) '
+
+ID_MASK = 0xFFFFFF
+
+SPEC = re.compile(r'%([-+ #0]*)(\d+|\*)?(?:\.(\d+))?(?:hh|h|ll|l|z|j|t)?([diuxXoscp%])')
+
+
+class Strings:
+    def __init__(self, path: Path) -> None:
+        with open(path, 'rb') as f:
+            elf = ELFFile(f)
+
+            section = elf.get_section_by_name('.trace_fmt')
+            if section is None:
+                exit(f'ERROR: {path} has no .trace_fmt section (built without CONFIG_TRACE?)')
+            self.formats = section.data()
+
+            # Loaded sections, so %s arguments pointing into kaeru
+            # can be shown as the string they point to.
+            self.loaded = [
+                (s['sh_addr'], s.data())
+                for s in elf.iter_sections()
+                if s['sh_flags'] & SH_FLAGS.SHF_ALLOC and s['sh_type'] != 'SHT_NOBITS'
+            ]
+
+    def format(self, fmt_id: int) -> str:
+        end = self.formats.find(b'\0', fmt_id)
+        if fmt_id >= len(self.formats) or end < 0:
+            return None
+        return self.formats[fmt_id:end].decode(errors='replace')
+
+    def string(self, addr: int, load_base: int) -> str:
+        # kaeru.o is linked at 0, the device saw it at load_base.
+        linked = (addr - load_base) & 0xFFFFFFFF
+        for base, data in self.loaded:
+            if base <= linked < base + len(data):
+                end = data.find(b'\0', linked - base)
+                return data[linked - base : end if end >= 0 else None].decode(errors='replace')
+        return f'<0x{addr:08x}>'
+
+
+def render(fmt: str, args: list[int], strings: Strings, load_base: int) -> str:
+    args = iter(args)
+
+    def convert(m: re.Match) -> str:
+        flags, width, precision, conv = m.groups()
+        if conv == '%':
+            return '%'
+
+        if width == '*':
+            width = str(next(args, 0))
+
+        value = next(args, 0)
+        spec = '%' + flags + (width or '') + (f'.{precision}' if precision else '')
+
+        if conv in 'di':
+            return (spec + 'd') % (value - (1 << 32) if value & 0x80000000 else value)
+        if conv == 'u':
+            return (spec + 'd') % value
+        if conv in 'xXo':
+            return (spec + conv) % value
+        if conv == 'c':
+            return (spec + 'c') % chr(value & 0xFF)
+        if conv == 's':
+            return (spec + 's') % strings.string(value, load_base)
+        return f'0x{value:08x}'
+
+    return SPEC.sub(convert, fmt)
+
+
+def capture(fastboot: str) -> str:
+    result = subprocess.run([fastboot, 'oem', 'trace'], capture_output=True, text=True)
+    if result.returncode:
+        exit(f'ERROR: fastboot failed:\n{result.stderr.strip()}')
+    return result.stderr
+
+
+def main() -> None:
+    parser = ArgumentParser(description='Decode kaeru binary trace')
+    parser.add_argument('elf', type=Path, help='kaeru.o of the running build')
+    parser.add_argument('--input', type=Path,
+                        help='Saved fastboot output to decode instead')
+    parser.add_argument('--fastboot', default='fastboot',
+                        help='fastboot binary to use (default: fastboot)')
+    args = parser.parse_args()
+
+    strings = Strings(args.elf)
+    log = args.input.read_text() if args.input else capture(args.fastboot)
+
+    total, load_base, entries, end = None, 0, [], None
+    for line in log.splitlines():
+        if not line.startswith(PREFIX):
+            continue
+
+        text = line[len(PREFIX) :].strip()
+        if text.startswith('trace '):
+            fields = text.split()
+            total, load_base, entries = int(fields[1]), int(fields[2], 16), []
+        elif text.startswith('end '):
+            end = int(text.split()[1])
+        elif total is not None:
+            entries.append(base64.b64decode(text))
+
+    if total is None or end is None or end != len(entries):
+        exit('ERROR: no complete trace in the fastboot output')
+
+    if total > len(entries):
+        print(f'[{total - len(entries)} older entries were overwritten]')
+
+    for entry in entries:
+        words = struct.unpack(f'<{len(entry) // 4}I', entry)
+        fmt = strings.format(words[0] & ID_MASK)
+
+        if fmt is None:
+            print(f'[unknown format 0x{words[0] & ID_MASK:06x}, wrong kaeru.o?]')
+            continue
+
+        print(render(fmt, list(words[1:]), strings, load_base), end='' if fmt.endswith('\n') else '\n')
+
+
+if __name__ == '__main__':
+    main()